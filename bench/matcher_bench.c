@@ -0,0 +1,145 @@
+/*
+  This program and the accompanying materials are
+  made available under the terms of the Eclipse Public License v2.0 which accompanies
+  this distribution, and is available at https://www.eclipse.org/legal/epl-v20.html
+
+  SPDX-License-Identifier: EPL-2.0
+
+  Copyright Contributors to the Zowe Project.
+*/
+
+/*
+  Compares the zowe.sysMessages matcher with the scan it replaced, one
+  index_of_string_limited() per message ID. Both look at the first
+  SYSLOG_MESSAGE_LENGTH_LIMIT bytes of every line and must agree on every line.
+
+  Built with the launcher flags, see the bench target of zosMakefile:
+    make -f zosMakefile bench && bin/matcher_bench [ids] [lines] [rounds]
+*/
+
+#define main zl_main
+#include "../src/main.c"
+#undef main
+
+// the scan of check_for_and_print_sys_message() before the matcher
+static int index_of_string_limited(const char *str, int len, const char *search_string, int start_pos, int search_limit){
+  int search_len = strlen(search_string);
+  int last_possible_start = len < search_limit ? len - search_len : search_limit - search_len;
+  int pos = start_pos;
+
+  if (start_pos > last_possible_start){
+    return -1;
+  }
+  while (pos <= last_possible_start){
+    if (!memcmp(str+pos,search_string,search_len)){
+      return pos;
+    }
+    pos++;
+  }
+  return -1;
+}
+
+static bool scan_find(const char **ids, int id_count, const char *line, int len) {
+  for (int i = 0; i < id_count; i++) {
+    if (index_of_string_limited(line, len, ids[i], 0, SYSLOG_MESSAGE_LENGTH_LIMIT) != -1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool matcher_find_line(const zl_matcher_t *matcher, const char *line, int len) {
+  return matcher_find(matcher, line, len < SYSLOG_MESSAGE_LENGTH_LIMIT ? len : SYSLOG_MESSAGE_LENGTH_LIMIT);
+}
+
+#define LINE_SIZE 200
+
+int main(int argc, char **argv) {
+  int id_count = argc > 1 ? atoi(argv[1]) : 300;
+  int line_count = argc > 2 ? atoi(argv[2]) : 2000;
+  int rounds = argc > 3 ? atoi(argv[3]) : 20;
+  if (id_count < 4 || line_count <= 0 || rounds <= 0) {
+    fprintf(stderr, "usage: %s [ids >= 4] [lines] [rounds]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  char (*id_buf)[16] = malloc(id_count * sizeof(*id_buf));
+  const char **ids = malloc(id_count * sizeof(char *));
+  char (*lines)[LINE_SIZE] = malloc(line_count * sizeof(*lines));
+  if (!id_buf || !ids || !lines) {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  // message IDs like the ones in zowe.sysMessages, plus overlapping ones for the failure links
+  srand(1);
+  for (int i = 0; i < id_count; i++) {
+    snprintf(id_buf[i], sizeof(id_buf[i]), "ZWE%c%c%04d%c", 'A' + rand() % 26, 'A' + rand() % 26, rand() % 10000,
+             "IEW"[rand() % 3]);
+    ids[i] = id_buf[i];
+  }
+  ids[1] = "AB";
+  ids[2] = "ABAB";
+  ids[3] = "BA";
+
+  // random 20-190 byte lines, a quarter of them with a message ID
+  const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 -:.";
+  for (int i = 0; i < line_count; i++) {
+    int len = 20 + rand() % 170;
+    for (int j = 0; j < len; j++) {
+      lines[i][j] = alphabet[rand() % 40];
+    }
+    lines[i][len] = '\0';
+    if (rand() % 4 == 0) {
+      const char *id = ids[rand() % id_count];
+      int id_len = strlen(id);
+      memcpy(lines[i] + rand() % (len - id_len), id, id_len);
+    }
+  }
+
+  uint64_t build_begin = get_time_us();
+  zl_matcher_t *matcher = make_matcher(ids, id_count);
+  uint64_t build_time = get_time_us() - build_begin;
+  if (!matcher) {
+    fprintf(stderr, "matcher not built\n");
+    return EXIT_FAILURE;
+  }
+
+  int mismatches = 0;
+  int hits = 0;
+  for (int i = 0; i < line_count; i++) {
+    int len = strlen(lines[i]);
+    bool expected = scan_find(ids, id_count, lines[i], len);
+    mismatches += expected != matcher_find_line(matcher, lines[i], len);
+    hits += expected;
+  }
+
+  volatile int sink = 0;
+  uint64_t scan_begin = get_time_us();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < line_count; i++) {
+      sink += scan_find(ids, id_count, lines[i], strlen(lines[i]));
+    }
+  }
+  uint64_t matcher_begin = get_time_us();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < line_count; i++) {
+      sink += matcher_find_line(matcher, lines[i], strlen(lines[i]));
+    }
+  }
+  uint64_t matcher_end = get_time_us();
+
+  double scan_ns = (matcher_begin - scan_begin) * 1000.0 / ((double)rounds * line_count);
+  double matcher_ns = (matcher_end - matcher_begin) * 1000.0 / ((double)rounds * line_count);
+  printf("ids = %d, lines = %d, rounds = %d, hits = %d, mismatches = %d\n", id_count, line_count, rounds, hits, mismatches);
+  printf("matcher built in %lu us, states = %d, byte classes = %d\n", (unsigned long)build_time,
+         matcher->state_count, matcher->class_count);
+  printf("per line: scan %.1f ns, matcher %.1f ns, x%.1f\n", scan_ns, matcher_ns,
+         matcher_ns > 0 ? scan_ns / matcher_ns : 0.0);
+
+  free_matcher(matcher);
+  free(lines);
+  free(ids);
+  free(id_buf);
+  return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -109,6 +109,7 @@ xlclang \
   -DLE_MAX_SUPPORTED_ZOS=0x01030100u \
   -DNEW_CAA_LOCATIONS=1 \
   -DUSE_ZOWE_TLS=1 \
+  -DLAUNCHER_VERSION="${VERSION}" \
   -I "${LAUNCHER}/src/msg.h" \
   -I "${DEPS_DESTINATION}/${COMMON}/h" \
   -I "${DEPS_DESTINATION}/${COMMON}/platform/posix" \
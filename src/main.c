@@ -13,22 +13,29 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
 #include <errno.h>
-#include <regex.h>
 #include <time.h>
 #include <sys/time.h>
 
 #include <pthread.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <stdatomic.h>
 #include <signal.h>
 #include <spawn.h>
 #include <sys/wait.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <sys/__messag.h>
+#ifdef __MVS__
+#include <builtins.h>
+#endif
 #include <unistd.h>
 #include "msg.h"
 
@@ -41,6 +48,7 @@
 #include "stcbase.h"
 #include "zos.h"
 #include "yaml2json.h"
+#include "embeddedjs.h"
 
 extern char ** environ;
 /*
@@ -62,11 +70,74 @@ extern char ** environ;
 #define MIN_UPTIME_SECS 90
 
 #define SHUTDOWN_GRACEFUL_PERIOD (20 * 1000)
+// wait for the exit of a component after SIGKILL before giving up on it, in ms
+#define SHUTDOWN_KILL_WAIT (5 * 1000)
 
-#define SHUTDOWN_POLLING_INTERVAL 300
+// longest single wait of the supervisor for events, in ms
+#define EVENT_WAIT_MAX_MS 1000
 
 #define COMP_LIST_SIZE 1024
 
+// files the launcher keeps in the workspace directory
+#define LAUNCHER_DIR ".launcher"
+
+// component output lines longer than this are truncated, see launcher.maxLineLength
+#define LINE_LENGTH_DEFAULT 4096
+#define LINE_LENGTH_LIMIT 16000
+#define LINE_TRUNCATED_MARKER " [truncated]"
+
+// component output waiting for the log writer, see launcher.outputBufferSize,
+// launcher.outputSpillSize and launcher.outputPolicy
+#define OUTPUT_BUFFER_SIZE_DEFAULT (1024 * 1024)
+#define OUTPUT_SPILL_SIZE_DEFAULT (64 * 1024 * 1024)
+#define OUTPUT_SPILL_READ_SIZE 65536
+#define OUTPUT_DRAIN_INTERVAL_MS 10
+
+// component log files in <workspaceDirectory>/logs, see launcher.logFile
+#define LOG_FILE_DIR "logs"
+#define LOG_FILE_BUFFER_SIZE 65536
+#define LOG_FILE_MAX_SIZE_DEFAULT (10 * 1024 * 1024)
+#define LOG_FILE_MAX_AGE_DEFAULT (24 * 60 * 60) // secs
+#define LOG_FILE_RETENTION_DEFAULT 5
+#define LOG_FILE_RETENTION_MAX 100
+#define LOG_FILE_DROP_REPORT_INTERVAL (60 * 1000) // ms between the warnings about dropped lines
+
+// startup order, see launcher.dependsOn, launcher.readyMessage, launcher.readyTimeout
+// and zowe.launcher.startupConcurrency
+#define READY_TIMEOUT_DEFAULT 300 // secs
+#define CRITICAL_PATH_LENGTH 1024
+
+// manifests probed in parallel by get_component_list, see zowe.launcher.manifestScanThreads
+#define MANIFEST_SCAN_THREADS_DEFAULT 4
+#define MANIFEST_SCAN_THREADS_MAX 16
+
+// what the manifests said, reused while a manifest file is unchanged
+#define MANIFEST_CACHE_FILE "manifest.cache"
+#define MANIFEST_CACHE_FORMAT 1
+#define MANIFEST_CACHE_HEADER "ZWELNCH manifest cache"
+
+// the merged and validated configuration written once for the components, see write_config_snapshot()
+#define CONFIG_SNAPSHOT_FILE "zowe-config.json"
+#define CONFIG_SNAPSHOT_ENV "ZWE_PRIVATE_CONFIG_SNAPSHOT"
+#define CONFIG_SNAPSHOT_HASH_ENV "ZWE_PRIVATE_CONFIG_SNAPSHOT_HASH"
+
+// the hash of the last configuration and schemas that passed validation, see zowe.launcher.forceValidation
+#define VALIDATION_CACHE_FILE "validation.cache"
+#define VALIDATION_CACHE_HEADER "ZWELNCH validation cache 1"
+
+// the hash of the prepare inputs when the instance was last prepared, see zowe.launcher.forcePrepare
+#define PREPARE_FINGERPRINT_FILE "prepare.fingerprint"
+#define PREPARE_FINGERPRINT_HEADER "ZWELNCH prepare fingerprint 1"
+
+#ifndef LAUNCHER_VERSION
+#define LAUNCHER_VERSION "unknown"
+#endif
+
+// the size of a read of component output adapts between these
+#define LINE_READ_SIZE_MIN 512
+#define LINE_READ_SIZE_INITIAL 4096
+#define LINE_READ_SIZE_MAX 65536
+
 #define LAUNCHER_MESSAGE_LENGTH_LIMIT 512
 #define SYSLOG_MESSAGE_LENGTH_LIMIT 126
 
@@ -76,6 +147,13 @@ extern char ** environ;
 
 #define YAML_ERROR_MAX 1024
 
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+// the configuration index grows when it is half full
+#define CONFIG_INDEX_SIZE_INITIAL 256
+#define CONFIG_PATH_MAX 1024
+
 // Progressive restart internals in seconds
 static int restart_intervals_default[] = {1, 1, 1, 5, 5, 10, 20, 60, 120, 240};
 
@@ -83,30 +161,256 @@ static int restart_intervals_default[] = {1, 1, 1, 5, 5, 10, 20, 60, 120, 240};
 static bool prevent_restart = false;
 
 static char** shared_uss_env = NULL;
+static char *shared_uss_env_arena = NULL; // the strings of shared_uss_env
+static size_t shared_uss_env_count = 0;
+
+#define ENV_NAME_AND_LEN(name) name, sizeof(name) - 1
 
 typedef struct zl_time_t {
   char value[32];
 } zl_time_t;
 
+/*
+ * Clock service. The formatted "YYYY-MM-DD HH:MM:SS" part of the log
+ * timestamp only changes once per second, so it is cached and a log record
+ * only costs one gettimeofday() plus patching in the milliseconds.
+ * Uptime, restart delays and grace periods use the monotonic clock, so
+ * setting the system clock doesn't affect them.
+ */
+static struct {
+  pthread_mutex_t lock;
+  time_t second;
+  char prefix[24];
+  size_t prefix_len;
+} zl_clock = {.lock = PTHREAD_MUTEX_INITIALIZER, .second = -1};
+
 static zl_time_t gettime(void) {
 
-  time_t t = time(NULL);
-  const char *format = "%Y-%m-%d %H:%M:%S";
+  struct timeval now;
+  gettimeofday(&now, NULL);
 
-  struct tm lt;
   zl_time_t result;
 
-  gmtime_r(&t, &lt);
-
-  strftime(result.value, sizeof(result.value), format, &lt);
+  pthread_mutex_lock(&zl_clock.lock);
+  if (now.tv_sec != zl_clock.second) {
+    const char *format = "%Y-%m-%d %H:%M:%S";
+    struct tm lt;
+    time_t t = now.tv_sec;
+    gmtime_r(&t, &lt);
+    zl_clock.prefix_len = strftime(zl_clock.prefix, sizeof(zl_clock.prefix), format, &lt);
+    zl_clock.second = now.tv_sec;
+  }
+  size_t len = zl_clock.prefix_len;
+  memcpy(result.value, zl_clock.prefix, len);
+  pthread_mutex_unlock(&zl_clock.lock);
 
-  struct timeval now;
-  gettimeofday(&now, NULL);
   int milli = now.tv_usec / 1000;
-  snprintf(result.value+strlen(result.value), 5, ".%03d", milli);
+  result.value[len++] = '.';
+  result.value[len++] = '0' + milli / 100;
+  result.value[len++] = '0' + milli / 10 % 10;
+  result.value[len++] = '0' + milli % 10;
+  result.value[len] = '\0';
 
   return result;
 }
+
+/**
+ * @brief Monotonic time in microseconds, only meaningful as a difference
+ */
+static uint64_t get_time_us(void) {
+#if defined(CLOCK_MONOTONIC)
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#else
+  // bit 51 of the TOD clock is a microsecond, the TOD clock is never set back
+  unsigned long long tod;
+  __stck(&tod);
+  return tod >> 12;
+#endif
+}
+
+/**
+ * @brief Monotonic time in milliseconds, only meaningful as a difference
+ */
+static uint64_t get_time_ms(void) {
+  return get_time_us() / 1000;
+}
+
+/*
+ * Hierarchical timer wheel used by the supervisor for restart delays and
+ * shutdown deadlines. Arming and cancelling a timer is O(1), and a timer
+ * only costs its zl_timer_t, which the owner embeds in its own struct.
+ *
+ * Level 0 has one slot per tick; every level above covers TIMER_WHEEL_SLOTS
+ * slots of the level below and is cascaded down when the lower level wraps.
+ * The wheel is not thread safe, it must only be used by the supervisor.
+ */
+#define TIMER_TICK_MS 100
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS 4
+
+typedef struct zl_timer_t zl_timer_t;
+
+typedef void (*zl_timer_callback_t)(zl_timer_t *timer);
+
+struct zl_timer_t {
+  zl_timer_t *next;
+  zl_timer_t *prev;
+  uint64_t expires; // tick
+  zl_timer_callback_t callback;
+  void *data;
+};
+
+typedef struct zl_timer_wheel_t {
+  uint64_t current; // tick
+  size_t count;
+  zl_timer_t slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} zl_timer_wheel_t;
+
+static void init_timer_list(zl_timer_t *head) {
+  head->next = head;
+  head->prev = head;
+}
+
+static bool is_timer_armed(const zl_timer_t *timer) {
+  return timer->next != NULL;
+}
+
+static void init_timer_wheel(zl_timer_wheel_t *wheel, uint64_t now_ms) {
+  wheel->current = now_ms / TIMER_TICK_MS;
+  wheel->count = 0;
+  for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+      init_timer_list(&wheel->slots[level][slot]);
+    }
+  }
+}
+
+static void add_timer_to_wheel(zl_timer_wheel_t *wheel, zl_timer_t *timer) {
+  uint64_t max_delta = ((uint64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+  if (timer->expires <= wheel->current) {
+    timer->expires = wheel->current + 1;
+  } else if (timer->expires - wheel->current > max_delta) {
+    timer->expires = wheel->current + max_delta;
+  }
+  uint64_t delta = timer->expires - wheel->current;
+  int level = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 && delta >= ((uint64_t)1 << (TIMER_WHEEL_BITS * (level + 1)))) {
+    level++;
+  }
+  zl_timer_t *head = &wheel->slots[level][(timer->expires >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+  timer->prev = head->prev;
+  timer->next = head;
+  head->prev->next = timer;
+  head->prev = timer;
+}
+
+static void unlink_timer(zl_timer_t *timer) {
+  timer->prev->next = timer->next;
+  timer->next->prev = timer->prev;
+  timer->next = NULL;
+  timer->prev = NULL;
+}
+
+/**
+ * @brief Arm a timer, re-arming it if it is already armed
+ *
+ * @param wheel The timer wheel
+ * @param timer The timer, its callback and data must be set
+ * @param now_ms Current time
+ * @param delay_ms Delay after which the callback is called
+ */
+static void arm_timer(zl_timer_wheel_t *wheel, zl_timer_t *timer, uint64_t now_ms, uint64_t delay_ms) {
+  if (is_timer_armed(timer)) {
+    unlink_timer(timer);
+    wheel->count--;
+  }
+  // round up so a timer never fires early
+  timer->expires = (now_ms + delay_ms + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+  add_timer_to_wheel(wheel, timer);
+  wheel->count++;
+}
+
+static void cancel_timer(zl_timer_wheel_t *wheel, zl_timer_t *timer) {
+  if (is_timer_armed(timer)) {
+    unlink_timer(timer);
+    wheel->count--;
+  }
+}
+
+static void cascade_timers(zl_timer_wheel_t *wheel, int level) {
+  zl_timer_t *head = &wheel->slots[level][(wheel->current >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+  zl_timer_t pending;
+  init_timer_list(&pending);
+  if (head->next != head) {
+    pending.next = head->next;
+    pending.prev = head->prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    init_timer_list(head);
+  }
+  while (pending.next != &pending) {
+    zl_timer_t *timer = pending.next;
+    unlink_timer(timer);
+    add_timer_to_wheel(wheel, timer);
+  }
+}
+
+/**
+ * @brief Advance the wheel to the current time and call the callbacks of
+ * the expired timers. Callbacks may arm and cancel timers.
+ */
+static void run_timers(zl_timer_wheel_t *wheel, uint64_t now_ms) {
+  uint64_t target = now_ms / TIMER_TICK_MS;
+  if (wheel->count == 0) {
+    wheel->current = target > wheel->current ? target : wheel->current;
+    return;
+  }
+  while (wheel->current < target) {
+    wheel->current++;
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+      if ((wheel->current & (((uint64_t)1 << (TIMER_WHEEL_BITS * level)) - 1)) != 0) {
+        break;
+      }
+      cascade_timers(wheel, level);
+    }
+    zl_timer_t *head = &wheel->slots[0][wheel->current & TIMER_WHEEL_MASK];
+    while (head->next != head) {
+      zl_timer_t *timer = head->next;
+      unlink_timer(timer);
+      wheel->count--;
+      timer->callback(timer);
+    }
+    if (wheel->count == 0) {
+      wheel->current = target;
+    }
+  }
+}
+
+/**
+ * @brief Get how long the supervisor may sleep before the wheel needs to run
+ *
+ * @return int64_t delay in milliseconds, -1 if no timer is armed
+ */
+static int64_t get_timer_wait_ms(zl_timer_wheel_t *wheel, uint64_t now_ms) {
+  if (wheel->count == 0) {
+    return -1;
+  }
+  // the nearest busy slot of level 0, or the next cascade
+  uint64_t tick = wheel->current + 1;
+  for (int i = 0; i < TIMER_WHEEL_SLOTS; i++, tick++) {
+    zl_timer_t *head = &wheel->slots[0][tick & TIMER_WHEEL_MASK];
+    if (head->next != head || (tick & TIMER_WHEEL_MASK) == 0) {
+      break;
+    }
+  }
+  int64_t wait_ms = (int64_t)(tick * TIMER_TICK_MS) - (int64_t)now_ms;
+  return wait_ms > 0 ? wait_ms : 0;
+}
+
 typedef struct zl_int_array_t {
   int count;
 #define ZL_INT_ARRAY_CAPACITY 100
@@ -119,16 +423,114 @@ typedef struct zl_config_t {
   bool debug_mode;
 } zl_config_t;
 
+/**
+ * @brief Splits the output of a component channel into lines. The incomplete
+ * line at the end of a read is carried over to the next read.
+ */
+typedef struct zl_line_framer_t {
+  char *buffer;
+  size_t capacity;
+  size_t len; // bytes of the incomplete line
+  size_t read_size;
+  bool truncating; // the rest of an over-long line is being skipped
+} zl_line_framer_t;
+
+/**
+ * @brief Component output the log writer couldn't take yet. Lines are kept in
+ * memory up to the buffer size, then appended to a spill file in the
+ * workspace, and written in order when the log writer catches up.
+ */
+typedef struct zl_output_backlog_t {
+  char *buffer;
+  size_t capacity;
+  size_t head;
+  size_t len;
+  int spill_fd; // -1 until something is spilled
+  off_t spill_read; // next spilled byte to write to the log
+  off_t spill_write; // end of the spilled output
+  bool spill_failed;
+  bool dropping;
+  // read by DISP from other threads
+  atomic_ulong lag; // bytes in memory and in the spill file
+  atomic_ulong spilled_bytes;
+  atomic_ulong dropped_lines;
+} zl_output_backlog_t;
+
+/**
+ * @brief A component log file, rotated by size and age. The settings are
+ * read at init, the rest is only used by the file writer.
+ */
+typedef struct zl_log_file_t {
+  bool enabled;
+  size_t max_size; // bytes, 0 disables rotation by size
+  int max_age; // secs, 0 disables rotation by age
+  int retention; // number of rotated files kept
+  enum {
+    ZL_LOG_FSYNC_NEVER,
+    ZL_LOG_FSYNC_ROTATE, // when the file is rotated or closed
+    ZL_LOG_FSYNC_ALWAYS, // after every write
+  } fsync;
+
+  int fd; // -1 until the first write
+  char *buffer;
+  size_t len;
+  off_t size; // bytes written to the file
+  uint64_t opened; // monotonic ms
+  bool failed;
+  uint64_t drop_reported; // monotonic ms, only used by the reactor
+  atomic_ulong dropped_lines; // the file writer was full
+} zl_log_file_t;
+
+/**
+ * @brief Flattened view of the merged configuration. Every node is indexed by
+ * its dot-separated path, e.g. "zowe.launcher.minUptime", so a setting is found
+ * with one hash lookup instead of a walk from the root. Arrays are leaves.
+ */
+typedef struct zl_config_entry_t {
+  char *path;
+  Json *value;
+} zl_config_entry_t;
+
+typedef struct zl_config_index_t {
+  zl_config_entry_t *entries;
+  size_t capacity; // a power of 2
+  size_t count;
+} zl_config_index_t;
+
+// where a launcher setting of a component can be set, in order of precedence
+enum zl_setting_level_t {
+  ZL_SETTING_HA_INSTANCE, // haInstances.<id>.components.<name>.launcher
+  ZL_SETTING_COMPONENT, // components.<name>.launcher
+  ZL_SETTING_LAUNCHER, // zowe.launcher
+  ZL_SETTING_LEVEL_COUNT
+};
+
+typedef struct zl_setting_t {
+  const char *key;
+  Json *values[ZL_SETTING_LEVEL_COUNT]; // NULL where the setting is not set
+} zl_setting_t;
+
+/**
+ * @brief The launcher settings of a component, resolved once from the three
+ * levels. A typed lookup takes the first level with a value of that type.
+ */
+typedef struct zl_settings_t {
+  zl_setting_t *entries;
+  size_t capacity; // a power of 2
+  size_t count;
+} zl_settings_t;
+
 typedef struct zl_comp_t {
 
   char name[32];
   char bin[_POSIX_PATH_MAX + 1];
   pid_t pid;
   int output;
+  bool forked; // by the fork server, which reports its exit, protected by the reactor lock
 
   bool clean_stop;
   int fail_cnt;
-  time_t start_time;
+  uint64_t start_time; // monotonic ms
 
   enum {
     ZL_COMP_AS_SHARE_NO,
@@ -136,37 +538,163 @@ typedef struct zl_comp_t {
     ZL_COMP_AS_SHARE_MUST,
   } share_as;
 
-  pthread_t comm_thid;
+  int exit_status;
+  bool restart_requested; // start again as soon as the component has stopped
+
+  zl_timer_t restart_timer;
+  zl_timer_t stop_timer;
+
+  // shutdown order, see launcher.gracePeriod and launcher.stopOrder
+  int grace_period; // ms between SIGTERM and SIGKILL
+  int stop_order; // lower stops first
+  bool stop_pending; // waiting for the components to be stopped before it
+  bool kill_sent;
+  uint64_t stop_begin; // monotonic ms
 
   zl_int_array_t restart_intervals;
   int min_uptime; // secs
+  int max_line_length;
+
+  enum {
+    ZL_OUTPUT_BLOCK, // stop reading the output when the backlog is full
+    ZL_OUTPUT_DROP, // drop lines when the backlog is full
+  } output_policy;
+  size_t output_buffer_size;
+  size_t output_spill_size; // 0 disables spilling
+
+  zl_output_backlog_t backlog; // only changed by the reactor
+
+  bool sysprint; // write the output to stdout
+  zl_log_file_t log_file;
+
+  zl_settings_t settings;
+
+  // built once, points into the shared environment
+  const char **envp;
+  char component_env[sizeof("ZWE_CLI_PARAMETER_COMPONENT=") + 32];
+
+  // launcher.dependsOn, resolved to indices of zl_context.children
+#define MAX_DEPENDENCY_COUNT 16
+  int dependencies[MAX_DEPENDENCY_COUNT];
+  int dependency_count;
+  char ready_message[16]; // the component is ready once it prints this message ID
+  int ready_timeout; // secs, 0 waits forever
+
+  enum {
+    ZL_STARTUP_WAITING, // for its prerequisites or a free startup slot
+    ZL_STARTUP_STARTING, // started, the ready message has not been seen yet
+    ZL_STARTUP_READY,
+    ZL_STARTUP_FAILED, // not started or not ready in time, dependents don't wait for it
+  } startup_state;
+  atomic_bool awaiting_ready; // the reactor checks the output for the ready message
+  uint64_t ready_time; // ms since the startup began
+  int critical_dependency; // the prerequisite which was the last to be ready, -1 if none
+  zl_timer_t ready_timer;
 
 } zl_comp_t;
 
+// A component stdout pipe watched by the I/O reactor. A component that has
+// been restarted can briefly own two channels: the old one is kept until its
+// forks close the pipe so that no output gets lost.
+typedef struct zl_channel_t {
+  int fd;
+  zl_comp_t *comp;
+  zl_line_framer_t *framer;
+} zl_channel_t;
+
+// Maps the PID of a running component back to the component for the reaper
+typedef struct zl_pid_entry_t {
+  pid_t pid;
+  zl_comp_t *comp;
+} zl_pid_entry_t;
+
 enum zl_event_t {
   ZL_EVENT_NONE = 0,
   ZL_EVENT_TERM,
-  ZL_EVENT_COMP_RESTART,
+  ZL_EVENT_COMP_EXIT,
+  ZL_EVENT_COMP_START,
+  ZL_EVENT_COMP_STOP,
+  ZL_EVENT_COMP_READY,
 };
 
+typedef struct zl_event_entry_t {
+  enum zl_event_t type;
+  void *data;
+} zl_event_entry_t;
+
+#define MAX_CHILD_COUNT 128
+
+typedef struct zl_fork_exit_t {
+  pid_t pid;
+  int status;
+} zl_fork_exit_t;
+
+typedef struct zl_fork_server_t {
+  pid_t pid;
+  int socket; // fork requests and replies
+  int exits; // exit status of the forked components, read by the reactor
+  // the fields below are protected by the reactor lock
+  bool available;
+  bool released; // the components it forked have been released
+  // exits of components the fork server has forked and the launcher hasn't indexed yet
+  zl_fork_exit_t unclaimed[MAX_CHILD_COUNT];
+  size_t unclaimed_count;
+} zl_fork_server_t;
+
 struct {
 
   pthread_t console_thid;
 
-#define MAX_CHILD_COUNT 128
-
   zl_comp_t children[MAX_CHILD_COUNT];
   size_t child_count;
 
+  pthread_t reactor_thid;
+  pthread_mutex_t reactor_lock;
+  int reactor_wakeup[2];
+  bool reactor_running;
+  bool reactor_stop;
+
+#define MAX_CHANNEL_COUNT (MAX_CHILD_COUNT * 2)
+
+  zl_channel_t channels[MAX_CHANNEL_COUNT];
+  size_t channel_count;
+
+// must be a power of 2 and at least twice MAX_CHILD_COUNT
+#define PID_INDEX_SIZE 256
+
+  zl_pid_entry_t pid_index[PID_INDEX_SIZE];
+
   zl_config_t config;
+  zl_config_index_t config_index;
 
   bool is_term;
 
-  enum zl_event_t event_type;
-  void *event_data;
+  // bounded queue of events, filled by send_event() and drained in
+  // batches by monitor_events()
+#define EVENT_QUEUE_SIZE 256
+
+  zl_event_entry_t events[EVENT_QUEUE_SIZE];
+  size_t event_head;
+  size_t event_count;
+  unsigned long events_enqueued;
+  unsigned long events_processed;
+  unsigned long events_dropped;
   pthread_cond_t event_cv;
   pthread_mutex_t event_lock;
 
+  zl_timer_wheel_t timers;
+  uint64_t shutdown_begin; // monotonic ms
+  bool shutting_down;
+  bool shutdown_done;
+  bool shutdown_forced;
+  bool console_stopped;
+
+  zl_fork_server_t fork_server;
+
+  int startup_concurrency; // components starting at the same time, 0 is unlimited
+  uint64_t startup_begin; // monotonic ms
+  bool startup_done;
+
   //Room for at least 16 paths
   //config_path is what the user types in
   char config_path[PATH_MAX*17];
@@ -175,13 +703,23 @@ struct {
   char parm_member[8+1];
   char *root_dir;
   char *workspace_dir;
-  JsonArray *sys_messages;
+  struct zl_matcher_t *sys_messages;
+  // bit n is set if launcher message ZWELnnnn is listed in zowe.sysMessages
+  unsigned char syslog_routes[(MSG_NUMBER_LIMIT + 7) / 8];
   char ha_instance_id[64];
+  uint32_t manifest_hash; // identities of the enabled component manifests, see get_component_list()
+  // passed to the components if the configuration snapshot has been written
+  char config_snapshot_env[sizeof(CONFIG_SNAPSHOT_ENV "=") + PATH_MAX];
+  char config_snapshot_hash_env[sizeof(CONFIG_SNAPSHOT_HASH_ENV "=") + 8];
   
   pid_t pid;
   char userid[9];
   
-} zl_context = {.config = {.debug_mode = false}, .userid = "(NONE)"} ;
+} zl_context = {
+  .config = {.debug_mode = false},
+  .fork_server = {.pid = -1, .socket = -1, .exits = -1},
+  .userid = "(NONE)"
+};
 
 // Wrapper for wtoPrintf3
 static void printf_wto(const char *formatString, ...) {
@@ -191,137 +729,831 @@ static void printf_wto(const char *formatString, ...) {
   va_end(argPointer);
 }
 
-static void set_sys_messages(ConfigManager *configmgr) {
-  Json *env;
-  int cfgGetStatus = cfgGetAnyC(configmgr, ZOWE_CONFIG_NAME, &env, 2, "zowe", "sysMessages");
+/*
+ * Multi-pattern matcher for zowe.sysMessages: an Aho-Corasick automaton
+ * compiled into a DFA, so a line is scanned once whatever the number of
+ * message IDs. Bytes that don't occur in any ID share the input class 0,
+ * which keeps the transition table small.
+ */
+typedef struct zl_matcher_t {
+  unsigned char byte_class[256];
+  int class_count;
+  int state_count;
+  int *next;     // state_count * class_count transitions
+  bool *accept;  // a message ID ends in this state
+} zl_matcher_t;
+
+static void free_matcher(zl_matcher_t *matcher) {
+  if (matcher) {
+    free(matcher->next);
+    free(matcher->accept);
+    free(matcher);
+  }
+}
 
-  if (cfgGetStatus != ZCFG_SUCCESS) { // No sysMessages found in Zowe configuration
-    return;
+/**
+ * @brief Compile the message IDs into a matcher
+ *
+ * @param ids The message IDs, NULL entries are skipped
+ * @param id_count Number of IDs
+ * @return zl_matcher_t* the matcher or NULL if there is nothing to match
+ */
+static zl_matcher_t *make_matcher(const char **ids, int id_count) {
+  zl_matcher_t *matcher = calloc(1, sizeof(zl_matcher_t));
+  if (!matcher) {
+    return NULL;
   }
-  JsonArray *sys_messages = jsonAsArray(env);
-  
-  if (sys_messages) {
-    zl_context.sys_messages = sys_messages;
+
+  int max_states = 1;
+  matcher->class_count = 1;
+  for (int i = 0; i < id_count; i++) {
+    if (!ids[i]) {
+      continue;
+    }
+    for (const unsigned char *c = (const unsigned char *)ids[i]; *c; c++) {
+      if (!matcher->byte_class[*c]) {
+        matcher->byte_class[*c] = matcher->class_count++;
+      }
+      max_states++;
+    }
+  }
+  if (max_states == 1) {
+    free(matcher);
+    return NULL;
   }
-}
 
-static void launcher_syslog_on_match(const char* fmt, ...) {
-  if (!zl_context.sys_messages) {
-    return;
+  int class_count = matcher->class_count;
+  matcher->next = calloc((size_t)max_states * class_count, sizeof(int));
+  matcher->accept = calloc(max_states, sizeof(bool));
+  int *fail = calloc(max_states, sizeof(int));
+  int *queue = calloc(max_states, sizeof(int));
+  if (!matcher->next || !matcher->accept || !fail || !queue) {
+    free(fail);
+    free(queue);
+    free_matcher(matcher);
+    return NULL;
   }
-  
-  /* All of this stuff here is because I can't do 
-  #define INFO(fmt, ...)  check_for_and_print_sys_message(fmt, ...) so let's make a string */
-  char input_string[LAUNCHER_MESSAGE_LENGTH_LIMIT+1];
-  va_list args;
-  va_start(args, fmt);
-  vsnprintf(input_string, sizeof(input_string), fmt, args);
-  va_end(args);
-    
-  int count = jsonArrayGetCount(zl_context.sys_messages);
-  for (int i = 0; i < count; i++) {
-      const char *sys_message_id = jsonArrayGetString(zl_context.sys_messages, i);
-      if (sys_message_id && strstr(input_string, sys_message_id)) {
-          printf_wto(input_string); // Print our match to the syslog
-          break;
+
+  // build the trie, state 0 is the root so 0 also means "no edge" here
+  matcher->state_count = 1;
+  for (int i = 0; i < id_count; i++) {
+    if (!ids[i] || !ids[i][0]) {
+      continue;
+    }
+    int state = 0;
+    for (const unsigned char *c = (const unsigned char *)ids[i]; *c; c++) {
+      int *edge = &matcher->next[state * class_count + matcher->byte_class[*c]];
+      if (!*edge) {
+        *edge = matcher->state_count++;
       }
+      state = *edge;
+    }
+    matcher->accept[state] = true;
   }
-  
+
+  // breadth-first pass: compute the failure links and turn the missing
+  // edges into the transitions of the failure state
+  int head = 0;
+  int tail = 0;
+  for (int c = 0; c < class_count; c++) {
+    int child = matcher->next[c];
+    if (child) {
+      fail[child] = 0;
+      queue[tail++] = child;
+    }
+  }
+  while (head < tail) {
+    int state = queue[head++];
+    if (matcher->accept[fail[state]]) {
+      matcher->accept[state] = true;
+    }
+    for (int c = 0; c < class_count; c++) {
+      int *edge = &matcher->next[state * class_count + c];
+      int fail_next = matcher->next[fail[state] * class_count + c];
+      if (*edge) {
+        fail[*edge] = fail_next;
+        queue[tail++] = *edge;
+      } else {
+        *edge = fail_next;
+      }
+    }
+  }
+
+  free(fail);
+  free(queue);
+  return matcher;
 }
 
-static int index_of_string_limited(const char *str, int len, const char *search_string, int start_pos, int search_limit){
-  int search_len = strlen(search_string);
-  int last_possible_start = len < search_limit ? len - search_len : search_limit - search_len;
-  int pos = start_pos;
+/**
+ * @brief Check if any of the message IDs occurs in the first len bytes
+ */
+static bool matcher_find(const zl_matcher_t *matcher, const char *str, int len) {
+  int state = 0;
+  for (int i = 0; i < len; i++) {
+    state = matcher->next[state * matcher->class_count + matcher->byte_class[(unsigned char)str[i]]];
+    if (matcher->accept[state]) {
+      return true;
+    }
+  }
+  return false;
+}
 
-  if (start_pos > last_possible_start){
+/**
+ * @brief Get the numeric ID of a launcher message
+ *
+ * @param id Text starting with a message ID, e.g. "ZWEL0021I ..."
+ * @return int the message number or -1 if the text doesn't start with a launcher message ID
+ */
+static int get_message_number(const char *id) {
+  if (strncmp(id, MSG_PREFIX, MSG_PREFIX_LEN)) {
     return -1;
   }
-  while (pos <= last_possible_start){
-    if (!memcmp(str+pos,search_string,search_len)){
-      return pos;
+  int number = 0;
+  for (int i = MSG_PREFIX_LEN; i < MSG_PREFIX_LEN + MSG_NUMBER_DIGITS; i++) {
+    if (!isdigit((unsigned char)id[i])) {
+      return -1;
     }
-    pos++;
+    number = number * 10 + (id[i] - '0');
   }
-  return -1;
+  return number;
 }
 
-//size of "ZWE_zowe_sysMessages"
-#define ZWE_SYSMESSAGES_EXCLUDE_LEN 20
-
-// matches YYYY-MM-DD starting with 2xxx.
-// this regex was chosen because other patterns didnt seem to work with LE's regex library.
-#define DATE_PREFIX_REGEXP_PATTERN "^[2-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9].*"
-
-// zowe standard "YYYY-MM-DD HH-MM-SS.sss "
-#define DATE_PREFIX_LEN 24
+static bool is_routed_to_syslog(const char *fmt) {
+  int number = get_message_number(fmt);
+  return number >= 0 && (zl_context.syslog_routes[number / 8] & (1 << (number % 8)));
+}
 
-static void check_for_and_print_sys_message(const char* input_string) {
-  if (!zl_context.sys_messages) {
+/**
+ * @brief Mark a launcher message ID from zowe.sysMessages in the syslog routes
+ *
+ * Accepts both "ZWELnnnn" and "ZWELnnnnS", other IDs only match component output.
+ */
+static void add_syslog_route(const char *id) {
+  size_t len = strlen(id);
+  if (len != MSG_PREFIX_LEN + MSG_NUMBER_DIGITS && len != MSG_PREFIX_LEN + MSG_NUMBER_DIGITS + 1) {
     return;
   }
+  int number = get_message_number(id);
+  if (number >= 0) {
+    zl_context.syslog_routes[number / 8] |= 1 << (number % 8);
+  }
+}
 
-  int count = jsonArrayGetCount(zl_context.sys_messages);
-  int input_length = strlen(input_string);
-  for (int i = 0; i < count; i++) {
-    const char *sys_message_id = jsonArrayGetString(zl_context.sys_messages, i);
-    if (sys_message_id && (index_of_string_limited(input_string, input_length, sys_message_id, 0, SYSLOG_MESSAGE_LENGTH_LIMIT) != -1)) {
-
-      //exclude "ZWE_zowe_sysMessages" messages to avoid spam.
-      if (memcmp("ZWE_zowe_sysMessages", input_string, ZWE_SYSMESSAGES_EXCLUDE_LEN)){ 
-
-        //truncate match for reasonable output
-        char syslog_string[SYSLOG_MESSAGE_LENGTH_LIMIT+1] = {0};
-        regex_t time_regex;
-        int regex_rc = regcomp(&time_regex, DATE_PREFIX_REGEXP_PATTERN, 0);
-        int match = regexec(&time_regex, input_string, 0, NULL, 0);
-        int offset = match == 0 ? DATE_PREFIX_LEN : 0;
-        int length = SYSLOG_MESSAGE_LENGTH_LIMIT < (input_length-offset) ? SYSLOG_MESSAGE_LENGTH_LIMIT : input_length-offset;
-        memcpy(syslog_string, input_string+offset, length);  
-        syslog_string[length] = '\0';
-        printf_wto(syslog_string);// Print our match to the syslog
-        break;
-      }
-    }
+static uint32_t hash_string(uint32_t hash, const char *str) {
+  // FNV-1a
+  for (const unsigned char *c = (const unsigned char *)str; *c; c++) {
+    hash = (hash ^ *c) * FNV_PRIME;
   }
-  
+  return hash;
 }
 
-#define INFO(fmt, ...)  launcher_syslog_on_match(fmt, ##__VA_ARGS__); \
-  printf("%s <%s:%d> %s INFO "fmt, gettime().value, COMP_ID, zl_context.pid, zl_context.userid, ##__VA_ARGS__)
-#define WARN(fmt, ...)  launcher_syslog_on_match(fmt, ##__VA_ARGS__); \
-  printf("%s <%s:%d> %s WARN "fmt, gettime().value, COMP_ID, zl_context.pid, zl_context.userid, ##__VA_ARGS__)
-#define DEBUG(fmt, ...) if (zl_context.config.debug_mode) \
-  printf("%s <%s:%d> %s DEBUG "fmt, gettime().value, COMP_ID, zl_context.pid, zl_context.userid, ##__VA_ARGS__)
-#define ERROR(fmt, ...) launcher_syslog_on_match(fmt, ##__VA_ARGS__); \
-  printf("%s <%s:%d> %s ERROR "fmt, gettime().value, COMP_ID, zl_context.pid, zl_context.userid, ##__VA_ARGS__)
+static zl_config_entry_t *find_config_entry(const zl_config_index_t *index, const char *path) {
+  if (!index->capacity) {
+    return NULL;
+  }
+  size_t mask = index->capacity - 1;
+  for (size_t i = hash_string(FNV_OFFSET_BASIS, path) & mask; index->entries[i].path; i = (i + 1) & mask) {
+    if (!strcmp(index->entries[i].path, path)) {
+      return &index->entries[i];
+    }
+  }
+  return NULL;
+}
 
-static int mkdir_all(const char *path, mode_t mode) {
-    // test if path exists
-    struct stat info;
-    if (!stat(path, &info)) {
-        DEBUG("Directory '%s' exists\n", path);
-        return 0;
+static int grow_config_index(zl_config_index_t *index) {
+  size_t capacity = index->capacity ? index->capacity * 2 : CONFIG_INDEX_SIZE_INITIAL;
+  zl_config_entry_t *entries = calloc(capacity, sizeof(zl_config_entry_t));
+  if (!entries) {
+    return -1;
+  }
+  for (size_t i = 0; i < index->capacity; i++) {
+    zl_config_entry_t *entry = &index->entries[i];
+    if (!entry->path) {
+      continue;
     }
+    size_t j = hash_string(FNV_OFFSET_BASIS, entry->path) & (capacity - 1);
+    while (entries[j].path) {
+      j = (j + 1) & (capacity - 1);
+    }
+    entries[j] = *entry;
+  }
+  free(index->entries);
+  index->entries = entries;
+  index->capacity = capacity;
+  return 0;
+}
 
-    // verify path length
-    int path_len = strlen(path);
-    if (path_len >= PATH_MAX) {
-        ERROR(MSG_MKDIR_ERR, path, "The path is too long to be processed");
-        return -1;
+static int add_config_entry(zl_config_index_t *index, const char *path, Json *value) {
+  if ((index->count + 1) * 2 > index->capacity && grow_config_index(index)) {
+    return -1;
+  }
+  size_t mask = index->capacity - 1;
+  size_t i = hash_string(FNV_OFFSET_BASIS, path) & mask;
+  while (index->entries[i].path) {
+    if (!strcmp(index->entries[i].path, path)) {
+      index->entries[i].value = value;
+      return 0;
     }
+    i = (i + 1) & mask;
+  }
+  index->entries[i].path = strdup(path);
+  if (!index->entries[i].path) {
+    return -1;
+  }
+  index->entries[i].value = value;
+  index->count++;
+  return 0;
+}
 
-    char curr_path[PATH_MAX] = {0};
-    memcpy(curr_path, path, path_len);
+static int index_config_node(zl_config_index_t *index, char *path, size_t len, Json *node) {
+  if (len && add_config_entry(index, path, node)) {
+    return -1;
+  }
+  if (!jsonIsObject(node)) {
+    return 0;
+  }
+  for (JsonProperty *prop = jsonAsObject(node)->firstProperty; prop != NULL; prop = prop->next) {
+    int key_len = snprintf(path + len, CONFIG_PATH_MAX - len, "%s%s", len ? "." : "", prop->key);
+    // a path too long to be looked up is not indexed
+    if (key_len >= 0 && len + key_len < CONFIG_PATH_MAX && index_config_node(index, path, len + key_len, prop->value)) {
+      return -1;
+    }
+    path[len] = '\0';
+  }
+  return 0;
+}
 
-    // find the latest existing folder
-    int slash_index = path_len;
-    for (int i = slash_index; i > 0; i--) {
-        if (path[i] == '/') {
-            // remember the latest check slash
-            slash_index = i;
+/**
+ * @brief Index the merged configuration in one pass, the configuration doesn't
+ * change once it is loaded
+ */
+static int build_config_index(ConfigManager *configmgr) {
+  char path[CONFIG_PATH_MAX] = {0};
+  return index_config_node(&zl_context.config_index, path, 0, cfgGetConfigData(configmgr, ZOWE_CONFIG_NAME));
+}
 
-            // shortcut the string before the slash
+/**
+ * @brief Get a configuration node by the path built from the format
+ *
+ * @return Json* NULL if the path is not in the configuration
+ */
+static Json *get_config_value(const char *fmt, ...) {
+  char path[CONFIG_PATH_MAX];
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(path, sizeof(path), fmt, args);
+  va_end(args);
+  if (len < 0 || len >= (int)sizeof(path)) {
+    return NULL;
+  }
+  zl_config_entry_t *entry = find_config_entry(&zl_context.config_index, path);
+  return entry ? entry->value : NULL;
+}
+
+static int get_json_int(Json *value, int *result) {
+  if (!value) {
+    return ZCFG_POINTER_TOO_DEEP;
+  }
+  if (!jsonIsNumber(value)) {
+    return ZCFG_TYPE_MISMATCH;
+  }
+  *result = jsonAsNumber(value);
+  return ZCFG_SUCCESS;
+}
+
+static int get_json_string(Json *value, char **result) {
+  if (!value) {
+    return ZCFG_POINTER_TOO_DEEP;
+  }
+  if (!jsonIsString(value)) {
+    return ZCFG_TYPE_MISMATCH;
+  }
+  *result = jsonAsString(value);
+  return ZCFG_SUCCESS;
+}
+
+static int get_json_bool(Json *value, bool *result) {
+  if (!value) {
+    return ZCFG_POINTER_TOO_DEEP;
+  }
+  if (!jsonIsBoolean(value)) {
+    return ZCFG_TYPE_MISMATCH;
+  }
+  *result = jsonAsBoolean(value);
+  return ZCFG_SUCCESS;
+}
+
+static void set_sys_messages(ConfigManager *configmgr) {
+  Json *env;
+  int cfgGetStatus = cfgGetAnyC(configmgr, ZOWE_CONFIG_NAME, &env, 2, "zowe", "sysMessages");
+
+  if (cfgGetStatus != ZCFG_SUCCESS) { // No sysMessages found in Zowe configuration
+    return;
+  }
+  JsonArray *sys_messages = jsonAsArray(env);
+  if (!sys_messages) {
+    return;
+  }
+
+  int count = jsonArrayGetCount(sys_messages);
+  const char **ids = malloc((count + 1) * sizeof(char *));
+  for (int i = 0; i < count; i++) {
+    ids[i] = jsonArrayGetString(sys_messages, i);
+    if (ids[i]) {
+      add_syslog_route(ids[i]);
+    }
+  }
+  zl_context.sys_messages = make_matcher(ids, count);
+  free(ids);
+}
+
+/*
+ * Asynchronous log writers. Producers (the launcher log macros, the component
+ * output reactor and the prepare step) copy pre-formatted records into a
+ * bounded lock-free ring; a dedicated thread per writer hands them to its
+ * sink in batches, so a slow SYSPRINT stalls only the writer thread.
+ * zl_log_writer writes to stdout, zl_file_writer to the component log files.
+ *
+ * A record takes one or more consecutive slots, which are reserved with a
+ * single CAS on the tail. Every slot has a sequence number telling whether it
+ * is free (seq == position), published (seq == position + 1) or free again
+ * for the next lap of the ring (seq == position + LOG_RING_SLOTS).
+ */
+#define LOG_SLOT_SIZE 256
+#define LOG_RING_SLOTS 4096
+#define LOG_RING_MASK (LOG_RING_SLOTS - 1)
+#define LOG_RECORD_MAX_SLOTS 64
+#define LOG_FLUSH_LATENCY_DEFAULT 50 // ms
+#define LOG_FLUSH_LATENCY_MAX 5000 // ms
+#define LOG_BATCH_SIZE_DEFAULT 256 // slots
+#define LOG_BATCH_SIZE_MAX 1024 // slots, must not exceed IOV_MAX
+
+typedef struct zl_log_slot_t {
+  atomic_size_t seq;
+  int slot_count; // number of slots of the record, only set in its first slot
+  int sink; // only set in the first slot
+  int len;
+  char data[LOG_SLOT_SIZE];
+} zl_log_slot_t;
+
+typedef struct zl_log_writer_t zl_log_writer_t;
+
+/**
+ * @brief Write a batch of records to the sinks of a writer
+ *
+ * @param iov The slots of the records
+ * @param sinks The sink of the record starting at iov[i], -1 for the other slots of a record
+ * @param iov_count Number of slots, 0 if the writer is idle
+ */
+typedef void (*zl_log_batch_writer_t)(zl_log_writer_t *writer, struct iovec *iov, const int *sinks, int iov_count);
+
+struct zl_log_writer_t {
+  const char *name;
+  zl_log_slot_t slots[LOG_RING_SLOTS];
+  atomic_size_t tail; // next position to reserve
+  atomic_size_t head; // next position to write, only advanced by the writer thread
+  atomic_bool running;
+  atomic_int producers; // producers between the running check and publishing
+  pthread_t thid;
+  int flush_latency; // ms
+  int batch_size;
+  zl_log_batch_writer_t write_batch;
+
+  atomic_ulong records;
+  atomic_ulong bytes_written;
+  atomic_ulong flushes;
+  atomic_ulong flush_time_us;
+  atomic_ulong max_flush_time_us;
+  atomic_ulong full_waits;
+};
+
+static void write_stdout_batch(zl_log_writer_t *writer, struct iovec *iov, const int *sinks, int iov_count);
+
+static zl_log_writer_t zl_log_writer = {
+  .name = "stdout",
+  .flush_latency = LOG_FLUSH_LATENCY_DEFAULT,
+  .batch_size = LOG_BATCH_SIZE_DEFAULT,
+  .write_batch = write_stdout_batch
+};
+
+// started by start_file_writer() if a component has a log file
+static zl_log_writer_t zl_file_writer = {
+  .name = "file",
+  .flush_latency = LOG_FLUSH_LATENCY_DEFAULT,
+  .batch_size = LOG_BATCH_SIZE_DEFAULT
+};
+
+static void write_all(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t written = write(fd, data, len);
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    data += written;
+    len -= written;
+  }
+}
+
+/**
+ * @brief writev() everything
+ *
+ * @return ssize_t bytes written or -1 on error
+ */
+static ssize_t writev_all(int fd, struct iovec *iov, int iov_count) {
+  ssize_t total = 0;
+  while (iov_count > 0) {
+    ssize_t written = writev(fd, iov, iov_count);
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    total += written;
+    while (iov_count > 0 && (size_t)written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      iov_count--;
+    }
+    if (iov_count > 0) {
+      iov->iov_base = (char *)iov->iov_base + written;
+      iov->iov_len -= written;
+    }
+  }
+  return total;
+}
+
+static void write_stdout_batch(zl_log_writer_t *writer, struct iovec *iov, const int *sinks, int iov_count) {
+  if (iov_count == 0) {
+    return;
+  }
+  // keep the order with anything else printed with stdio
+  fflush(stdout);
+  ssize_t written = writev_all(STDOUT_FILENO, iov, iov_count);
+  if (written > 0) {
+    atomic_fetch_add(&writer->bytes_written, written);
+  }
+}
+
+/**
+ * @brief Copy a log record into the ring of a writer, records over LOG_RECORD_MAX_SLOTS slots are truncated
+ *
+ * Records for a writer that isn't running are written directly.
+ *
+ * @param writer The writer
+ * @param sink The sink of the record, e.g. the component index for the file writer
+ * @param data Record
+ * @param len Record length
+ * @param add_newline Append a new line to the record
+ * @param wait Wait for the writer if the ring is full
+ * @return bool false if the ring is full and wait is false
+ */
+static bool put_log_record(zl_log_writer_t *writer, int sink, const char *data, size_t len, bool add_newline, bool wait) {
+  size_t total = len + (add_newline ? 1 : 0);
+  if (total > LOG_RECORD_MAX_SLOTS * LOG_SLOT_SIZE) {
+    total = LOG_RECORD_MAX_SLOTS * LOG_SLOT_SIZE;
+    len = total - (add_newline ? 1 : 0);
+  }
+
+  atomic_fetch_add(&writer->producers, 1);
+  if (!atomic_load(&writer->running)) {
+    atomic_fetch_sub(&writer->producers, 1);
+    struct iovec iov[2] = {{(char *)data, len}, {"\n", 1}};
+    int sinks[2] = {sink, -1};
+    writer->write_batch(writer, iov, sinks, add_newline ? 2 : 1);
+    return true;
+  }
+
+  int slot_count = total ? (total + LOG_SLOT_SIZE - 1) / LOG_SLOT_SIZE : 1;
+
+  size_t pos = atomic_load(&writer->tail);
+  while (true) {
+    // the writer frees the slots in order, so the last one is the last to become free
+    size_t last = pos + slot_count - 1;
+    size_t seq = atomic_load_explicit(&writer->slots[last & LOG_RING_MASK].seq, memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)last;
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak(&writer->tail, &pos, pos + slot_count)) {
+        break;
+      }
+    } else if (diff < 0) {
+      if (!wait) {
+        atomic_fetch_sub(&writer->producers, 1);
+        return false;
+      }
+      // the ring is full, wait for the writer
+      atomic_fetch_add(&writer->full_waits, 1);
+      struct timespec wait = {0, 1000000};
+      nanosleep(&wait, NULL);
+      pos = atomic_load(&writer->tail);
+    } else {
+      pos = atomic_load(&writer->tail);
+    }
+  }
+
+  size_t offset = 0;
+  for (int i = 0; i < slot_count; i++) {
+    zl_log_slot_t *slot = &writer->slots[(pos + i) & LOG_RING_MASK];
+    size_t chunk = total - offset < LOG_SLOT_SIZE ? total - offset : LOG_SLOT_SIZE;
+    size_t copy = offset + chunk <= len ? chunk : len - offset;
+    memcpy(slot->data, data + offset, copy);
+    if (copy < chunk) {
+      slot->data[copy] = '\n';
+    }
+    slot->len = chunk;
+    offset += chunk;
+  }
+  writer->slots[pos & LOG_RING_MASK].slot_count = slot_count;
+  writer->slots[pos & LOG_RING_MASK].sink = sink;
+  // publish the first slot last, the writer reads the record once it sees the first slot
+  for (int i = slot_count - 1; i >= 0; i--) {
+    atomic_store_explicit(&writer->slots[(pos + i) & LOG_RING_MASK].seq, pos + i + 1, memory_order_release);
+  }
+  atomic_fetch_add(&writer->records, 1);
+  atomic_fetch_sub(&writer->producers, 1);
+  return true;
+}
+
+static void write_log(const char *data, size_t len, bool add_newline) {
+  put_log_record(&zl_log_writer, -1, data, len, add_newline, true);
+}
+
+/**
+ * @brief Copy a log record into the stdout ring unless the ring is full
+ *
+ * @return bool false if the record has not been written
+ */
+static bool try_write_log(const char *data, size_t len, bool add_newline) {
+  return put_log_record(&zl_log_writer, -1, data, len, add_newline, false);
+}
+
+/**
+ * @brief Hand the published records to the sinks of the writer in one batch
+ *
+ * @return int number of slots written
+ */
+static int flush_log_batch(zl_log_writer_t *writer) {
+  struct iovec iov[LOG_BATCH_SIZE_MAX + LOG_RECORD_MAX_SLOTS];
+  int sinks[LOG_BATCH_SIZE_MAX + LOG_RECORD_MAX_SLOTS];
+  size_t head = atomic_load(&writer->head);
+  size_t pos = head;
+  int iov_count = 0;
+  while (iov_count < writer->batch_size) {
+    zl_log_slot_t *slot = &writer->slots[pos & LOG_RING_MASK];
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != pos + 1) {
+      break;
+    }
+    int slot_count = slot->slot_count;
+    if (iov_count > 0 && iov_count + slot_count > writer->batch_size) {
+      break;
+    }
+    for (int i = 0; i < slot_count; i++) {
+      zl_log_slot_t *part = &writer->slots[(pos + i) & LOG_RING_MASK];
+      iov[iov_count].iov_base = part->data;
+      iov[iov_count].iov_len = part->len;
+      sinks[iov_count] = i == 0 ? slot->sink : -1;
+      iov_count++;
+    }
+    pos += slot_count;
+  }
+  if (iov_count == 0) {
+    writer->write_batch(writer, iov, sinks, 0);
+    return 0;
+  }
+
+  uint64_t start = get_time_us();
+  writer->write_batch(writer, iov, sinks, iov_count);
+  unsigned long flush_time = get_time_us() - start;
+  atomic_fetch_add(&writer->flushes, 1);
+  atomic_fetch_add(&writer->flush_time_us, flush_time);
+  if (flush_time > atomic_load(&writer->max_flush_time_us)) {
+    atomic_store(&writer->max_flush_time_us, flush_time);
+  }
+
+  for (size_t i = head; i != pos; i++) {
+    atomic_store_explicit(&writer->slots[i & LOG_RING_MASK].seq, i + LOG_RING_SLOTS, memory_order_release);
+  }
+  atomic_store(&writer->head, pos);
+  return iov_count;
+}
+
+static bool has_published_record(zl_log_writer_t *writer) {
+  size_t head = atomic_load(&writer->head);
+  return atomic_load_explicit(&writer->slots[head & LOG_RING_MASK].seq, memory_order_acquire) == head + 1;
+}
+
+static void *handle_log_writer(void *args) {
+  zl_log_writer_t *writer = args;
+  while (true) {
+    // nobody can publish a new record once the writer is stopped and no producer is in flight
+    bool stopping = !atomic_load(&writer->running) && atomic_load(&writer->producers) == 0;
+    int written = flush_log_batch(writer);
+    if (stopping && !written) {
+      break;
+    }
+    if (!stopping && !has_published_record(writer)) {
+      // let the records accumulate for the next batch
+      struct timespec wait = {
+        writer->flush_latency / 1000,
+        (writer->flush_latency % 1000) * 1000000
+      };
+      nanosleep(&wait, NULL);
+    }
+  }
+  return NULL;
+}
+
+static int start_writer(zl_log_writer_t *writer) {
+  // a stopped writer can be started again from where it stopped
+  size_t head = atomic_load(&writer->head);
+  for (size_t i = 0; i < LOG_RING_SLOTS; i++) {
+    atomic_init(&writer->slots[(head + i) & LOG_RING_MASK].seq, head + i);
+  }
+  atomic_store(&writer->running, true);
+  if (pthread_create(&writer->thid, NULL, handle_log_writer, writer) != 0) {
+    atomic_store(&writer->running, false);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Stop a writer after it has written all the records, later records are written directly
+ */
+static void stop_writer(zl_log_writer_t *writer) {
+  if (!atomic_exchange(&writer->running, false)) {
+    return;
+  }
+  if (!pthread_equal(pthread_self(), writer->thid)) {
+    pthread_join(writer->thid, NULL);
+  }
+}
+
+static int start_log_writer(void) {
+  return start_writer(&zl_log_writer);
+}
+
+static void stop_log_writer(void) {
+  stop_writer(&zl_log_writer);
+}
+
+/**
+ * @brief Read zowe.launcher.logFlushLatency (ms) and zowe.launcher.logBatchSize (slots) for the log writers
+ */
+static void set_log_writer_options(void) {
+  int flush_latency = 0;
+  if (get_json_int(get_config_value("zowe.launcher.logFlushLatency"), &flush_latency) == ZCFG_SUCCESS) {
+    if (flush_latency >= 0 && flush_latency <= LOG_FLUSH_LATENCY_MAX) {
+      zl_log_writer.flush_latency = flush_latency;
+      zl_file_writer.flush_latency = flush_latency;
+    }
+  }
+  int batch_size = 0;
+  if (get_json_int(get_config_value("zowe.launcher.logBatchSize"), &batch_size) == ZCFG_SUCCESS) {
+    if (batch_size > 0 && batch_size <= LOG_BATCH_SIZE_MAX) {
+      zl_log_writer.batch_size = batch_size;
+      zl_file_writer.batch_size = batch_size;
+    }
+  }
+}
+
+// launcher log records shorter than this are formatted without a heap allocation
+#define LOG_RECORD_BUFFER_SIZE 4096
+
+/**
+ * @brief Format a launcher log record once and write it to stdout and, if routed, to syslog
+ *
+ * @param level Log level, e.g. "INFO"
+ * @param route Check fmt against the syslog routes
+ * @param fmt Message format, launcher messages start with their ID
+ */
+static void zl_log(const char *level, bool route, const char *fmt, ...) {
+  char buffer[LOG_RECORD_BUFFER_SIZE];
+  char *record = buffer;
+  int prefix_len = snprintf(buffer, sizeof(buffer), "%s <%s:%d> %s %s ",
+                            gettime().value, COMP_ID, zl_context.pid, zl_context.userid, level);
+  if (prefix_len < 0 || prefix_len >= (int)sizeof(buffer)) {
+    return;
+  }
+
+  va_list args;
+  va_start(args, fmt);
+  int msg_len = vsnprintf(buffer + prefix_len, sizeof(buffer) - prefix_len, fmt, args);
+  va_end(args);
+  if (msg_len < 0) {
+    return;
+  }
+
+  if (prefix_len + msg_len >= (int)sizeof(buffer)) {
+    record = malloc(prefix_len + msg_len + 1);
+    if (record) {
+      memcpy(record, buffer, prefix_len);
+      va_start(args, fmt);
+      vsnprintf(record + prefix_len, msg_len + 1, fmt, args);
+      va_end(args);
+    } else {
+      record = buffer;
+      msg_len = sizeof(buffer) - prefix_len - 1;
+    }
+  }
+
+  write_log(record, prefix_len + msg_len, false);
+
+  if (route && is_routed_to_syslog(fmt)) {
+    int wto_len = msg_len < LAUNCHER_MESSAGE_LENGTH_LIMIT ? msg_len : LAUNCHER_MESSAGE_LENGTH_LIMIT;
+    printf_wto("%.*s", wto_len, record + prefix_len); // Print our match to the syslog
+  }
+
+  if (record != buffer) {
+    free(record);
+  }
+}
+
+//size of "ZWE_zowe_sysMessages"
+#define ZWE_SYSMESSAGES_EXCLUDE_LEN 20
+
+// zowe standard "YYYY-MM-DD HH-MM-SS.sss "
+#define DATE_PREFIX_LEN 24
+
+/**
+ * @brief Check for a YYYY-MM-DD prefix with a year starting with 2-9
+ */
+static bool has_date_prefix(const char *str, int len) {
+  if (len < 10 || str[0] < '2' || str[0] > '9' || str[4] != '-' || str[7] != '-') {
+    return false;
+  }
+  const int digits[] = {1, 2, 3, 5, 6, 8, 9};
+  for (size_t i = 0; i < sizeof(digits) / sizeof(digits[0]); i++) {
+    if (!isdigit((unsigned char)str[digits[i]])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void check_for_and_print_sys_message(const char* input_string, int input_length) {
+  if (!zl_context.sys_messages) {
+    return;
+  }
+
+  int search_length = input_length < SYSLOG_MESSAGE_LENGTH_LIMIT ? input_length : SYSLOG_MESSAGE_LENGTH_LIMIT;
+  if (!matcher_find(zl_context.sys_messages, input_string, search_length)) {
+    return;
+  }
+
+  //exclude "ZWE_zowe_sysMessages" messages to avoid spam.
+  if (input_length < ZWE_SYSMESSAGES_EXCLUDE_LEN ||
+      strncmp("ZWE_zowe_sysMessages", input_string, ZWE_SYSMESSAGES_EXCLUDE_LEN)) {
+
+    //truncate match for reasonable output
+    char syslog_string[SYSLOG_MESSAGE_LENGTH_LIMIT+1] = {0};
+    int offset = has_date_prefix(input_string, input_length) ? DATE_PREFIX_LEN : 0;
+    if (offset > input_length) {
+      offset = input_length;
+    }
+    int length = SYSLOG_MESSAGE_LENGTH_LIMIT < (input_length-offset) ? SYSLOG_MESSAGE_LENGTH_LIMIT : input_length-offset;
+    memcpy(syslog_string, input_string+offset, length);
+    syslog_string[length] = '\0';
+    printf_wto("%s", syslog_string);// Print our match to the syslog
+  }
+
+}
+
+#define INFO(fmt, ...)  zl_log("INFO", true, fmt, ##__VA_ARGS__)
+#define WARN(fmt, ...)  zl_log("WARN", true, fmt, ##__VA_ARGS__)
+#define DEBUG(fmt, ...) if (zl_context.config.debug_mode) \
+  zl_log("DEBUG", false, fmt, ##__VA_ARGS__)
+#define ERROR(fmt, ...) zl_log("ERROR", true, fmt, ##__VA_ARGS__)
+
+static int mkdir_all(const char *path, mode_t mode) {
+    // test if path exists
+    struct stat info;
+    if (!stat(path, &info)) {
+        DEBUG("Directory '%s' exists\n", path);
+        return 0;
+    }
+
+    // verify path length
+    int path_len = strlen(path);
+    if (path_len >= PATH_MAX) {
+        ERROR(MSG_MKDIR_ERR, path, "The path is too long to be processed");
+        return -1;
+    }
+
+    char curr_path[PATH_MAX] = {0};
+    memcpy(curr_path, path, path_len);
+
+    // find the latest existing folder
+    int slash_index = path_len;
+    for (int i = slash_index; i > 0; i--) {
+        if (path[i] == '/') {
+            // remember the latest check slash
+            slash_index = i;
+
+            // shortcut the string before the slash
             curr_path[i] = 0;
 
             // if path to this slash exist continue creating subdirectories
@@ -453,11 +1685,90 @@ static bool is_valid_key(char *key) {
     return true;
 }
 
+// A variable name in the shared environment, pointing into the string it comes from
+typedef struct zl_env_key_t {
+  const char *name;
+  size_t len;
+} zl_env_key_t;
+
+/**
+ * @brief Builds the shared environment into one arena. Entries are kept as offsets
+ * while the arena grows, names are de-duplicated with a hash set.
+ */
+typedef struct zl_env_builder_t {
+  char *arena;
+  size_t size;
+  size_t capacity;
+  size_t *offsets;
+  size_t count;
+  zl_env_key_t *keys;
+  size_t key_capacity; // a power of 2
+} zl_env_builder_t;
+
+static uint32_t hash_bytes(uint32_t hash, const char *data, size_t len) {
+  // FNV-1a
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ (unsigned char)data[i]) * FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * @brief Add a variable name to the set
+ *
+ * @return bool false if the name is already there
+ */
+static bool add_env_key(zl_env_builder_t *builder, const char *name, size_t len) {
+  size_t mask = builder->key_capacity - 1;
+  size_t i = hash_bytes(FNV_OFFSET_BASIS, name, len) & mask;
+  while (builder->keys[i].name) {
+    if (builder->keys[i].len == len && !memcmp(builder->keys[i].name, name, len)) {
+      return false;
+    }
+    i = (i + 1) & mask;
+  }
+  builder->keys[i].name = name;
+  builder->keys[i].len = len;
+  return true;
+}
+
+static int add_env_entry(zl_env_builder_t *builder, const char *name, size_t name_len, const char *value) {
+  size_t value_len = strlen(value);
+  size_t needed = builder->size + name_len + value_len + 2;
+  if (needed > builder->capacity) {
+    size_t capacity = builder->capacity ? builder->capacity : 4096;
+    while (capacity < needed) {
+      capacity *= 2;
+    }
+    char *arena = realloc(builder->arena, capacity);
+    if (!arena) {
+      return -1;
+    }
+    builder->arena = arena;
+    builder->capacity = capacity;
+  }
+  char *entry = builder->arena + builder->size;
+  memcpy(entry, name, name_len);
+  entry[name_len] = '=';
+  memcpy(entry + name_len + 1, value, value_len + 1);
+  trimRight(entry, name_len + value_len + 1);
+  DEBUG("shared env pos %d is %s\n", (int)builder->count, entry);
+  builder->offsets[builder->count++] = builder->size;
+  builder->size += strlen(entry) + 1;
+  return 0;
+}
+
+static void free_shared_uss_env(void) {
+  free(shared_uss_env);
+  free(shared_uss_env_arena);
+  shared_uss_env = NULL;
+  shared_uss_env_arena = NULL;
+}
+
 static void set_shared_uss_env(ConfigManager *configmgr) {
   Json *env = NULL;
   int cfgGetStatus = cfgGetAnyC(configmgr, ZOWE_CONFIG_NAME, &env, 2, "zowe", "environments");
   JsonObject *object = NULL;
-  ArrayList *list = makeArrayList();
 
   if (cfgGetStatus == ZCFG_SUCCESS) {
     object = jsonAsObject(env);
@@ -469,39 +1780,42 @@ static void set_shared_uss_env(ConfigManager *configmgr) {
     maxRecords++;
   }
 
-  int idx = 0;
-
-  // _BPX_SHAREAS is set on component level
-  arrayListAdd(list, "_BPX_SHAREAS");
-
-
-  //These are all properties that should not be changed by zowe.environments
-  arrayListAdd(list, "ZWE_CLI_PARAMETER_CONFIG");
-  arrayListAdd(list, "ZWE_CLI_PARAMETER_HA_INSTANCE");
-  arrayListAdd(list, "ZWE_zowe_runtimeDirectory");
-
   if (object) { // environments block is defined in zowe.yaml
     for (JsonProperty *property = jsonObjectGetFirstProperty(object); property != NULL; property = jsonObjectGetNextProperty(property)) {
       maxRecords++;
     }
   }
 
-  shared_uss_env = malloc(maxRecords * sizeof(char*));
-  memset(shared_uss_env, 0, maxRecords * sizeof(char*));
+  zl_env_builder_t builder = {0};
+  builder.key_capacity = 16;
+  while (builder.key_capacity < (size_t)maxRecords * 2) {
+    builder.key_capacity *= 2;
+  }
+  builder.keys = calloc(builder.key_capacity, sizeof(zl_env_key_t));
+  builder.offsets = malloc(maxRecords * sizeof(size_t));
+  if (!builder.keys || !builder.offsets) {
+    ERROR("failed to build the shared environment - %s\n", strerror(ENOMEM));
+    free(builder.keys);
+    free(builder.offsets);
+    return;
+  }
 
-  char *configEnv = malloc(PATH_MAX+32);
-  char *runtimeEnv = malloc(PATH_MAX+32);
-  char *haEnv = malloc(256);
-  snprintf(configEnv, PATH_MAX+32, "ZWE_CLI_PARAMETER_CONFIG=%s", zl_context.config_path);
-  shared_uss_env[idx++] = configEnv;
-  snprintf(runtimeEnv, PATH_MAX+32, "ZWE_zowe_runtimeDirectory=%s", zl_context.root_dir);
-  shared_uss_env[idx++] = runtimeEnv;
-  snprintf(haEnv, 256, "ZWE_CLI_PARAMETER_HA_INSTANCE=%s", zl_context.ha_instance_id);
-  shared_uss_env[idx++] = haEnv;  
+  // _BPX_SHAREAS and ZWE_CLI_PARAMETER_COMPONENT are set on component level
+  add_env_key(&builder, ENV_NAME_AND_LEN("_BPX_SHAREAS"));
+  add_env_key(&builder, ENV_NAME_AND_LEN("ZWE_CLI_PARAMETER_COMPONENT"));
+
+  //These are all properties that should not be changed by zowe.environments
+  add_env_key(&builder, ENV_NAME_AND_LEN("ZWE_CLI_PARAMETER_CONFIG"));
+  add_env_key(&builder, ENV_NAME_AND_LEN("ZWE_CLI_PARAMETER_HA_INSTANCE"));
+  add_env_key(&builder, ENV_NAME_AND_LEN("ZWE_zowe_runtimeDirectory"));
+
+  int rc = add_env_entry(&builder, ENV_NAME_AND_LEN("ZWE_CLI_PARAMETER_CONFIG"), zl_context.config_path);
+  rc = rc ? rc : add_env_entry(&builder, ENV_NAME_AND_LEN("ZWE_zowe_runtimeDirectory"), zl_context.root_dir);
+  rc = rc ? rc : add_env_entry(&builder, ENV_NAME_AND_LEN("ZWE_CLI_PARAMETER_HA_INSTANCE"), zl_context.ha_instance_id);
 
   if (object) {
     // Get all environment variables defined in zowe.yaml and put them in the output as they are
-    for (JsonProperty *property = jsonObjectGetFirstProperty(object); property != NULL; property = jsonObjectGetNextProperty(property)) {
+    for (JsonProperty *property = jsonObjectGetFirstProperty(object); property != NULL && !rc; property = jsonObjectGetNextProperty(property)) {
       char *key = jsonPropertyGetKey(property);
       if (!is_valid_key(key)) {
         WARN("Key in zowe.yaml `zowe.environments.%s` is invalid and it will be ignored\n", key);
@@ -513,9 +1827,7 @@ static void set_shared_uss_env(ConfigManager *configmgr) {
         continue;
       }
 
-      if (!arrayListContains(list, key)) {
-        arrayListAdd(list, key);
-
+      if (add_env_key(&builder, key, strlen(key))) {
         Json *valueJ = jsonPropertyGetValue(property);
         char *value = jsonToString(valueJ);
 
@@ -523,18 +1835,18 @@ static void set_shared_uss_env(ConfigManager *configmgr) {
           continue;
         }
 
-        char *entry = malloc(strlen(key) + strlen(value) + 2);
-
-        sprintf(entry, "%s=%s", key, value);
-        DEBUG("shared env pos %d is %s\n", idx, entry);
-        shared_uss_env[idx++] = entry;
+        rc = add_env_entry(&builder, key, strlen(key), value);
+        // booleans are static strings
+        if (!jsonIsBoolean(valueJ)) {
+          free(value);
+        }
       }
     }
   }
 
 
   // Get all environment variables defined in the system and put them in output if they were not already defined in zowe.yaml
-  for (char **env = environ; *env != 0; env++) { 
+  for (char **env = environ; *env != 0 && !rc; env++) { 
     char *thisEnv = *env;
     char *index = strchr(thisEnv, '=');
     if (!index) {
@@ -546,23 +1858,27 @@ static void set_shared_uss_env(ConfigManager *configmgr) {
     }
 
     int length = index - thisEnv;
-    char *key = malloc(length + 1);
-    memset(key, 0, length + 1);
-    strncpy(key, thisEnv, length);
-    
-    if (!arrayListContains(list, key)) {
-      arrayListAdd(list, key);
-      int new_env_length = strlen(thisEnv);
-      char *new_env = malloc(new_env_length+1);
-      memset(new_env, 0, new_env_length+1);
-      strncpy(new_env, thisEnv, strlen(thisEnv));
-      DEBUG("shared env pos %d is %s\n", idx, new_env);
-      shared_uss_env[idx++] = new_env;
+    if (add_env_key(&builder, thisEnv, length)) {
+      rc = add_env_entry(&builder, thisEnv, length, index + 1);
     }
   }
 
-  shared_uss_env[idx] = NULL;
-  arrayListFree(list);
+  free(builder.keys);
+  if (rc || !(shared_uss_env = malloc((builder.count + 1) * sizeof(char *)))) {
+    ERROR("failed to build the shared environment - %s\n", strerror(ENOMEM));
+    free(builder.arena);
+    free(builder.offsets);
+    return;
+  }
+
+  // the arena doesn't move anymore
+  shared_uss_env_arena = builder.arena;
+  for (size_t i = 0; i < builder.count; i++) {
+    shared_uss_env[i] = builder.arena + builder.offsets[i];
+  }
+  shared_uss_env[builder.count] = NULL;
+  shared_uss_env_count = builder.count;
+  free(builder.offsets);
 }
 
 static int init_context(int argc, char **argv, const struct zl_config_t *cfg, ConfigManager *configmgr) {
@@ -645,6 +1961,8 @@ static int init_context(int argc, char **argv, const struct zl_config_t *cfg, Co
     return -1;
   }
 
+  init_timer_wheel(&zl_context.timers, get_time_ms());
+
   return 0;
 }
 
@@ -655,25 +1973,178 @@ static void snprint_int_array(zl_int_array_t *array, char *buf, size_t buf_size)
   }
 }
 
-static void init_component_restart_intervals(zl_comp_t *comp, ConfigManager *configmgr) {
-  DEBUG ("loading restart intervals for component '%s'\n", comp->name);
-  Json *restartIntArray;
+static zl_setting_t *find_comp_setting(const zl_settings_t *settings, const char *key) {
+  if (!settings->capacity) {
+    return NULL;
+  }
+  size_t mask = settings->capacity - 1;
+  for (size_t i = hash_string(FNV_OFFSET_BASIS, key) & mask; settings->entries[i].key; i = (i + 1) & mask) {
+    if (!strcmp(settings->entries[i].key, key)) {
+      return &settings->entries[i];
+    }
+  }
+  return NULL;
+}
+
+static Json *get_launcher_object(const zl_comp_t *comp, enum zl_setting_level_t level) {
+  switch (level) {
+  case ZL_SETTING_HA_INSTANCE:
+    return get_config_value("haInstances.%s.components.%s.launcher", zl_context.ha_instance_id, comp->name);
+  case ZL_SETTING_COMPONENT:
+    return get_config_value("components.%s.launcher", comp->name);
+  default:
+    return get_config_value("zowe.launcher");
+  }
+}
+
+/**
+ * @brief Resolve the launcher settings of a component from haInstances.<id>.components.<name>.launcher,
+ * components.<name>.launcher and zowe.launcher. The keys point into the configuration.
+ */
+static int init_component_settings(zl_comp_t *comp) {
+  zl_settings_t *settings = &comp->settings;
+  size_t key_count = 0;
+  for (int level = 0; level < ZL_SETTING_LEVEL_COUNT; level++) {
+    Json *launcher = get_launcher_object(comp, level);
+    if (jsonIsObject(launcher)) {
+      for (JsonProperty *prop = jsonAsObject(launcher)->firstProperty; prop != NULL; prop = prop->next) {
+        key_count++;
+      }
+    }
+  }
+
+  settings->capacity = 8;
+  while (settings->capacity < key_count * 2) {
+    settings->capacity *= 2;
+  }
+  settings->entries = calloc(settings->capacity, sizeof(zl_setting_t));
+  if (!settings->entries) {
+    settings->capacity = 0;
+    return -1;
+  }
+
+  size_t mask = settings->capacity - 1;
+  for (int level = 0; level < ZL_SETTING_LEVEL_COUNT; level++) {
+    Json *launcher = get_launcher_object(comp, level);
+    if (!jsonIsObject(launcher)) {
+      continue;
+    }
+    for (JsonProperty *prop = jsonAsObject(launcher)->firstProperty; prop != NULL; prop = prop->next) {
+      size_t i = hash_string(FNV_OFFSET_BASIS, prop->key) & mask;
+      while (settings->entries[i].key && strcmp(settings->entries[i].key, prop->key)) {
+        i = (i + 1) & mask;
+      }
+      if (!settings->entries[i].key) {
+        settings->entries[i].key = prop->key;
+        settings->count++;
+      }
+      settings->entries[i].values[level] = prop->value;
+    }
+  }
+  return 0;
+}
+
+static const char *get_setting_level_label(enum zl_setting_level_t level) {
+  switch (level) {
+  case ZL_SETTING_HA_INSTANCE:
+    return "haInstances";
+  case ZL_SETTING_COMPONENT:
+    return "components";
+  default:
+    return "zowe.launcher";
+  }
+}
+
+/**
+ * @brief Print the resolved launcher settings of a component, used in debug mode
+ */
+static void print_component_settings(const zl_comp_t *comp) {
+  const zl_settings_t *settings = &comp->settings;
+  for (size_t i = 0; i < settings->capacity; i++) {
+    const zl_setting_t *setting = &settings->entries[i];
+    if (!setting->key) {
+      continue;
+    }
+    for (int level = 0; level < ZL_SETTING_LEVEL_COUNT; level++) {
+      Json *value = setting->values[level];
+      if (!value) {
+        continue;
+      }
+      char buf[64];
+      if (jsonIsString(value)) {
+        snprintf(buf, sizeof(buf), "'%s'", jsonAsString(value));
+      } else if (jsonIsBoolean(value)) {
+        snprintf(buf, sizeof(buf), "%s", jsonAsBoolean(value) ? "true" : "false");
+      } else if (jsonIsNumber(value)) {
+        snprintf(buf, sizeof(buf), "%d", jsonAsNumber(value));
+      } else if (jsonIsArray(value)) {
+        snprintf(buf, sizeof(buf), "array of %d", jsonArrayGetCount(jsonAsArray(value)));
+      } else {
+        snprintf(buf, sizeof(buf), "object");
+      }
+      DEBUG("launcher setting %s of component %s = %s from %s\n", setting->key, comp->name, buf,
+            get_setting_level_label(level));
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Get the first value of a launcher setting of a component, from the levels before
+ * the given one
+ */
+static Json *get_comp_launcher_value(const zl_comp_t *comp, const char *key, enum zl_setting_level_t level_count) {
+  zl_setting_t *setting = find_comp_setting(&comp->settings, key);
+  for (int level = 0; setting && level < (int)level_count; level++) {
+    if (setting->values[level]) {
+      return setting->values[level];
+    }
+  }
+  return NULL;
+}
 
-  // if haInstances.<haInstanceId>.components.<componentName>.launcher.restartIntervals is defined use it
-  int getStatus = cfgGetAnyC(configmgr, ZOWE_CONFIG_NAME, &restartIntArray, 6, "haInstances", zl_context.ha_instance_id, "components", comp->name, "launcher", "restartIntervals");
+/**
+ * @brief Get a launcher setting of a component, looked up in haInstances.<id>.components.<name>.launcher,
+ * components.<name>.launcher and zowe.launcher. A value of another type is skipped.
+ *
+ * @return int ZCFG_SUCCESS if the setting has been found
+ */
+static int get_comp_launcher_int(const zl_comp_t *comp, const char *key, int *value) {
+  zl_setting_t *setting = find_comp_setting(&comp->settings, key);
+  int getStatus = ZCFG_POINTER_TOO_DEEP;
+  for (int level = 0; setting && level < ZL_SETTING_LEVEL_COUNT && getStatus != ZCFG_SUCCESS; level++) {
+    getStatus = get_json_int(setting->values[level], value);
+  }
+  return getStatus;
+}
 
-  // if no restartIntervals configuration found, try to use components.<componentName>.launcher.restartIntervals
-  if (getStatus != ZCFG_SUCCESS) {
-    getStatus = cfgGetAnyC(configmgr, ZOWE_CONFIG_NAME, &restartIntArray, 4, "components", comp->name, "launcher", "restartIntervals");
+static int get_comp_launcher_string(const zl_comp_t *comp, const char *key, char **value) {
+  zl_setting_t *setting = find_comp_setting(&comp->settings, key);
+  int getStatus = ZCFG_POINTER_TOO_DEEP;
+  for (int level = 0; setting && level < ZL_SETTING_LEVEL_COUNT && getStatus != ZCFG_SUCCESS; level++) {
+    getStatus = get_json_string(setting->values[level], value);
   }
+  return getStatus;
+}
 
-  // if no restartIntervals configuration found, try to use zowe.launcher.restartIntervals
-  if (getStatus != ZCFG_SUCCESS) {
-    getStatus = cfgGetAnyC(configmgr, ZOWE_CONFIG_NAME, &restartIntArray, 3, "zowe", "launcher", "restartIntervals");
+static int get_comp_launcher_bool(const zl_comp_t *comp, const char *key, bool *value) {
+  zl_setting_t *setting = find_comp_setting(&comp->settings, key);
+  int getStatus = ZCFG_POINTER_TOO_DEEP;
+  for (int level = 0; setting && level < ZL_SETTING_LEVEL_COUNT && getStatus != ZCFG_SUCCESS; level++) {
+    getStatus = get_json_bool(setting->values[level], value);
   }
+  return getStatus;
+}
+
+static void init_component_restart_intervals(zl_comp_t *comp) {
+  DEBUG ("loading restart intervals for component '%s'\n", comp->name);
+
+  // the first of haInstances.<haInstanceId>.components.<componentName>.launcher.restartIntervals,
+  // components.<componentName>.launcher.restartIntervals and zowe.launcher.restartIntervals
+  Json *restartIntArray = get_comp_launcher_value(comp, "restartIntervals", ZL_SETTING_LEVEL_COUNT);
 
   // if there is no configuration of restartIntervals, use the default (defined above)
-  if (getStatus != ZCFG_SUCCESS) {
+  if (!restartIntArray) {
     memcpy(&comp->restart_intervals.data, restart_intervals_default, sizeof(restart_intervals_default));
     comp->restart_intervals.count = sizeof(restart_intervals_default)/sizeof(restart_intervals_default[0]);
     return;
@@ -688,38 +2159,199 @@ static void init_component_restart_intervals(zl_comp_t *comp, ConfigManager *con
   }
 }
 
-static void init_component_min_uptime(zl_comp_t *comp, ConfigManager *configmgr) {
+static void init_component_min_uptime(zl_comp_t *comp) {
   int minUptime = MIN_UPTIME_SECS;
-  int getStatus = cfgGetIntC(configmgr, ZOWE_CONFIG_NAME, &minUptime, 6, "haInstances", zl_context.ha_instance_id, "components", comp->name, "launcher", "minUptime");
-  if (getStatus != ZCFG_SUCCESS) {
-    getStatus = cfgGetIntC(configmgr, ZOWE_CONFIG_NAME, &minUptime, 4, "components", comp->name, "launcher", "minUptime");
-    if (getStatus != ZCFG_SUCCESS) {
-      getStatus = cfgGetIntC(configmgr, ZOWE_CONFIG_NAME, &minUptime, 3, "zowe", "launcher", "minUptime");
-      if (getStatus != ZCFG_SUCCESS) {
-        comp->min_uptime = MIN_UPTIME_SECS;
-      } else {
-        comp->min_uptime = minUptime;
-      }
-    } else {
-      comp->min_uptime = minUptime;
-    }
+  int getStatus = get_comp_launcher_int(comp, "minUptime", &minUptime);
+  comp->min_uptime = getStatus == ZCFG_SUCCESS ? minUptime : MIN_UPTIME_SECS;
+}
+
+static void init_component_max_line_length(zl_comp_t *comp) {
+  int maxLineLength = LINE_LENGTH_DEFAULT;
+  int getStatus = get_comp_launcher_int(comp, "maxLineLength", &maxLineLength);
+  if (getStatus != ZCFG_SUCCESS || maxLineLength <= 0) {
+    comp->max_line_length = LINE_LENGTH_DEFAULT;
+  } else if (maxLineLength > LINE_LENGTH_LIMIT) {
+    comp->max_line_length = LINE_LENGTH_LIMIT;
   } else {
-    comp->min_uptime = minUptime;
+    comp->max_line_length = maxLineLength;
   }
 }
 
-static void init_component_shareas(zl_comp_t *comp, ConfigManager *configmgr) {
-  char *share_as = NULL;
-  int getStatus = cfgGetStringC(configmgr, ZOWE_CONFIG_NAME, &share_as, 6, "haInstances", zl_context.ha_instance_id, "components", comp->name, "launcher", "shareAs");
-  if (getStatus != ZCFG_SUCCESS) {
-    getStatus = cfgGetStringC(configmgr, ZOWE_CONFIG_NAME, &share_as, 4, "components", comp->name, "launcher", "shareAs");
-    if (getStatus != ZCFG_SUCCESS) {
-      getStatus = cfgGetStringC(configmgr, ZOWE_CONFIG_NAME, &share_as, 3, "zowe", "launcher", "shareAs");
-      if (getStatus != ZCFG_SUCCESS) {
-        share_as = "yes";
+static void init_component_output(zl_comp_t *comp) {
+  int bufferSize = OUTPUT_BUFFER_SIZE_DEFAULT;
+  int getStatus = get_comp_launcher_int(comp, "outputBufferSize", &bufferSize);
+  comp->output_buffer_size = (getStatus == ZCFG_SUCCESS && bufferSize > 0) ? bufferSize : OUTPUT_BUFFER_SIZE_DEFAULT;
+
+  int spillSize = OUTPUT_SPILL_SIZE_DEFAULT;
+  getStatus = get_comp_launcher_int(comp, "outputSpillSize", &spillSize);
+  comp->output_spill_size = (getStatus == ZCFG_SUCCESS && spillSize >= 0) ? spillSize : OUTPUT_SPILL_SIZE_DEFAULT;
+
+  char *policy = NULL;
+  getStatus = get_comp_launcher_string(comp, "outputPolicy", &policy);
+  comp->output_policy = (getStatus == ZCFG_SUCCESS && policy && !strcmp(policy, "drop")) ? ZL_OUTPUT_DROP : ZL_OUTPUT_BLOCK;
+
+  comp->backlog.spill_fd = -1;
+}
+
+static void init_component_log_file(zl_comp_t *comp) {
+  zl_log_file_t *log_file = &comp->log_file;
+  log_file->fd = -1;
+
+  bool enabled = false;
+  log_file->enabled = get_comp_launcher_bool(comp, "logFile", &enabled) == ZCFG_SUCCESS && enabled;
+
+  int maxSize = LOG_FILE_MAX_SIZE_DEFAULT;
+  int getStatus = get_comp_launcher_int(comp, "logMaxSize", &maxSize);
+  log_file->max_size = (getStatus == ZCFG_SUCCESS && maxSize >= 0) ? maxSize : LOG_FILE_MAX_SIZE_DEFAULT;
+
+  int maxAge = LOG_FILE_MAX_AGE_DEFAULT;
+  getStatus = get_comp_launcher_int(comp, "logMaxAge", &maxAge);
+  log_file->max_age = (getStatus == ZCFG_SUCCESS && maxAge >= 0) ? maxAge : LOG_FILE_MAX_AGE_DEFAULT;
+
+  int retention = LOG_FILE_RETENTION_DEFAULT;
+  getStatus = get_comp_launcher_int(comp, "logRetention", &retention);
+  log_file->retention = (getStatus == ZCFG_SUCCESS && retention >= 0 && retention <= LOG_FILE_RETENTION_MAX) ? retention : LOG_FILE_RETENTION_DEFAULT;
+
+  char *fsync_policy = NULL;
+  log_file->fsync = ZL_LOG_FSYNC_ROTATE;
+  if (get_comp_launcher_string(comp, "logFsync", &fsync_policy) == ZCFG_SUCCESS && fsync_policy) {
+    if (!strcmp(fsync_policy, "never")) {
+      log_file->fsync = ZL_LOG_FSYNC_NEVER;
+    } else if (!strcmp(fsync_policy, "always")) {
+      log_file->fsync = ZL_LOG_FSYNC_ALWAYS;
+    }
+  }
+
+  // without a log file the output always goes to stdout
+  bool sysprint = true;
+  getStatus = get_comp_launcher_bool(comp, "sysprint", &sysprint);
+  comp->sysprint = !log_file->enabled || getStatus != ZCFG_SUCCESS || sysprint;
+}
+
+static void handle_ready_timeout(zl_timer_t *timer);
+
+static void init_component_startup(zl_comp_t *comp) {
+  comp->critical_dependency = -1;
+  comp->ready_timer.callback = handle_ready_timeout;
+  comp->ready_timer.data = comp;
+
+  Json *readyMessage = get_comp_launcher_value(comp, "readyMessage", ZL_SETTING_LAUNCHER);
+  if (jsonIsString(readyMessage)) {
+    snprintf(comp->ready_message, sizeof(comp->ready_message), "%s", jsonAsString(readyMessage));
+  }
+
+  int readyTimeout = READY_TIMEOUT_DEFAULT;
+  int getStatus = get_comp_launcher_int(comp, "readyTimeout", &readyTimeout);
+  comp->ready_timeout = (getStatus == ZCFG_SUCCESS && readyTimeout >= 0) ? readyTimeout : READY_TIMEOUT_DEFAULT;
+}
+
+/**
+ * @brief Read launcher.gracePeriod (secs) and launcher.stopOrder of a component
+ */
+static void init_component_shutdown(zl_comp_t *comp) {
+  int gracePeriod = 0;
+  int getStatus = get_comp_launcher_int(comp, "gracePeriod", &gracePeriod);
+  comp->grace_period = (getStatus == ZCFG_SUCCESS && gracePeriod >= 0) ? gracePeriod * 1000 : SHUTDOWN_GRACEFUL_PERIOD;
+
+  int stopOrder = 0;
+  getStatus = get_comp_launcher_int(comp, "stopOrder", &stopOrder);
+  comp->stop_order = getStatus == ZCFG_SUCCESS ? stopOrder : 0;
+}
+
+static zl_comp_t *find_comp(const char *name);
+
+static void add_component_dependency(zl_comp_t *comp, const char *name) {
+  if (!name) {
+    return;
+  }
+  zl_comp_t *dependency = find_comp(name);
+  if (!dependency) {
+    WARN(MSG_DEP_UNKNOWN, comp->name, name);
+    return;
+  }
+  int index = dependency - zl_context.children;
+  for (int i = 0; i < comp->dependency_count; i++) {
+    if (comp->dependencies[i] == index) {
+      return;
+    }
+  }
+  if (comp->dependency_count == MAX_DEPENDENCY_COUNT) {
+    DEBUG("too many dependencies of component %s, %s ignored\n", comp->name, name);
+    return;
+  }
+  comp->dependencies[comp->dependency_count++] = index;
+}
+
+/**
+ * @brief Resolve launcher.dependsOn of a component, a component name or a list of them.
+ * All the components must have been initialized before.
+ */
+static void init_component_dependencies(zl_comp_t *comp) {
+  Json *dependsOn = get_comp_launcher_value(comp, "dependsOn", ZL_SETTING_LAUNCHER);
+  if (jsonIsString(dependsOn)) {
+    add_component_dependency(comp, jsonAsString(dependsOn));
+  } else if (jsonIsArray(dependsOn)) {
+    JsonArray *names = jsonAsArray(dependsOn);
+    int count = jsonArrayGetCount(names);
+    for (int i = 0; i < count; i++) {
+      add_component_dependency(comp, jsonArrayGetString(names, i));
+    }
+  }
+
+  if (comp->dependency_count > 0) {
+    char names[MAX_DEPENDENCY_COUNT * sizeof(comp->name)] = {0};
+    int pos = 0;
+    for (int i = 0; i < comp->dependency_count; i++) {
+      pos += snprintf(names + pos, sizeof(names) - pos, "%s%s", i ? ", " : "", zl_context.children[comp->dependencies[i]].name);
+    }
+    INFO(MSG_COMP_DEPENDS_ON, comp->name, names);
+  }
+}
+
+/**
+ * @brief Drop the dependencies that would keep components waiting for each other forever.
+ * Components without pending prerequisites are removed from the graph until only cycles
+ * are left, then the dependencies of one component of a cycle are dropped and so on.
+ */
+static void break_dependency_cycles(void) {
+  bool resolved[MAX_CHILD_COUNT] = {false};
+  size_t resolved_count = 0;
+
+  while (resolved_count < zl_context.child_count) {
+    bool progress = false;
+    for (size_t i = 0; i < zl_context.child_count; i++) {
+      zl_comp_t *comp = &zl_context.children[i];
+      if (resolved[i]) {
+        continue;
+      }
+      bool pending = false;
+      for (int j = 0; j < comp->dependency_count && !pending; j++) {
+        pending = !resolved[comp->dependencies[j]];
+      }
+      if (!pending) {
+        resolved[i] = true;
+        resolved_count++;
+        progress = true;
+      }
+    }
+    if (progress) {
+      continue;
+    }
+    for (size_t i = 0; i < zl_context.child_count; i++) {
+      if (!resolved[i]) {
+        WARN(MSG_DEP_CYCLE, zl_context.children[i].name);
+        zl_context.children[i].dependency_count = 0;
+        break;
       }
     }
   }
+}
+
+static void init_component_shareas(zl_comp_t *comp) {
+  char *share_as = NULL;
+  if (get_comp_launcher_string(comp, "shareAs", &share_as) != ZCFG_SUCCESS) {
+    share_as = "yes";
+  }
   
   if (!strcmp(share_as, "no")) {
     comp->share_as = ZL_COMP_AS_SHARE_NO;
@@ -730,7 +2362,6 @@ static void init_component_shareas(zl_comp_t *comp, ConfigManager *configmgr) {
   } else {
     comp->share_as = ZL_COMP_AS_SHARE_YES;
   }
-  safeFree(share_as, strlen(share_as));
 }
 
 static const char *get_shareas_label(const zl_comp_t *comp) {
@@ -746,16 +2377,34 @@ static const char *get_shareas_label(const zl_comp_t *comp) {
   }
 }
 
-static int init_component(const char *name, zl_comp_t *result, ConfigManager *configmgr) {
+
+static void handle_restart_timer(zl_timer_t *timer);
+static void handle_stop_timeout(zl_timer_t *timer);
+
+static int init_component(const char *name, zl_comp_t *result) {
   snprintf(result->name, sizeof(result->name), "%s", name);
   result->pid = -1;
-  init_component_shareas(result, configmgr);
-  init_component_restart_intervals(result, configmgr);
-  init_component_min_uptime(result, configmgr);
+  result->restart_timer.callback = handle_restart_timer;
+  result->restart_timer.data = result;
+  result->stop_timer.callback = handle_stop_timeout;
+  result->stop_timer.data = result;
+  if (init_component_settings(result)) {
+    DEBUG("launcher settings of component %s not resolved, using the defaults\n", result->name);
+  } else if (zl_context.config.debug_mode) {
+    print_component_settings(result);
+  }
+  init_component_shareas(result);
+  init_component_restart_intervals(result);
+  init_component_min_uptime(result);
+  init_component_max_line_length(result);
+  init_component_output(result);
+  init_component_log_file(result);
+  init_component_startup(result);
+  init_component_shutdown(result);
   
   INFO(MSG_COMP_INITED, result->name, result->restart_intervals.count, result->min_uptime, get_shareas_label(result));
 
-  char restart_intervals_buf[2048];
+  char restart_intervals_buf[2048] = {0};
   snprint_int_array(&result->restart_intervals, restart_intervals_buf, sizeof(restart_intervals_buf));
   INFO(MSG_RESTART_INTRVL, result->name, restart_intervals_buf);
   return 0;
@@ -776,7 +2425,37 @@ static const char *get_shareas_env(const zl_comp_t *comp) {
 
 }
 
-static int init_components(char *components, ConfigManager *configmgr) {
+/**
+ * @brief Build the environment of a component once: _BPX_SHAREAS and ZWE_CLI_PARAMETER_COMPONENT
+ * followed by the shared environment, whose strings are not copied
+ *
+ * @param comp The component
+ */
+static int init_component_env(zl_comp_t *comp) {
+  if (!shared_uss_env) {
+    return -1;
+  }
+  comp->envp = malloc((shared_uss_env_count + 5) * sizeof(char *));
+  if (!comp->envp) {
+    return -1;
+  }
+  snprintf(comp->component_env, sizeof(comp->component_env), "ZWE_CLI_PARAMETER_COMPONENT=%s", comp->name);
+
+  int i = 0;
+  comp->envp[i++] = get_shareas_env(comp);
+  comp->envp[i++] = comp->component_env;
+  if (zl_context.config_snapshot_env[0]) {
+    comp->envp[i++] = zl_context.config_snapshot_env;
+    comp->envp[i++] = zl_context.config_snapshot_hash_env;
+  }
+  for (size_t j = 0; j < shared_uss_env_count; j++) {
+    comp->envp[i++] = shared_uss_env[j];
+  }
+  comp->envp[i] = NULL;
+  return 0;
+}
+
+static int init_components(char *components) {
   if (!components) {
     DEBUG("components to launch not set\n");
     return -1;
@@ -784,128 +2463,1389 @@ static int init_components(char *components, ConfigManager *configmgr) {
   char *name = strtok(components, ",");
 
   while(name != NULL) {
-    zl_comp_t comp = { 0 };
-    init_component(name, &comp, configmgr);
     if (zl_context.child_count != MAX_CHILD_COUNT) {
-      zl_context.children[zl_context.child_count++] = comp;
+      // initialized in place, the component timers point back to it
+      zl_comp_t *comp = &zl_context.children[zl_context.child_count++];
+      memset(comp, 0, sizeof(*comp));
+      init_component(name, comp);
+      if (init_component_env(comp)) {
+        DEBUG("environment of component %s not built\n", comp->name);
+      }
     } else {
       ERROR(MSG_MAX_COMP_REACHED);
       break;
     }
     name = strtok(NULL, ",");
   }
+
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    init_component_dependencies(&zl_context.children[i]);
+  }
+  break_dependency_cycles();
+
+  int concurrency = 0;
+  int getStatus = get_json_int(get_config_value("zowe.launcher.startupConcurrency"), &concurrency);
+  zl_context.startup_concurrency = (getStatus == ZCFG_SUCCESS && concurrency > 0) ? concurrency : 0;
   return 0;
 }
 
 static int send_event(enum zl_event_t event_type, void *event_data);
 
-static void *handle_comp_comm(void *args) {
+// bytes written to the reactor self-pipe
+#define WAKEUP_BYTE_IO   'W'
+#define WAKEUP_BYTE_TERM 'T'
+
+// wait for the reply of the fork server before it's given up, in ms
+#define FORK_SERVER_REPLY_TIMEOUT (5 * 1000)
+
+static void wakeup_reactor(void) {
+  char signal_byte = WAKEUP_BYTE_IO;
+  if (write(zl_context.reactor_wakeup[1], &signal_byte, 1) == -1 && errno != EAGAIN) {
+    DEBUG("failed to wake up the reactor - %s\n", strerror(errno));
+  }
+}
+
+static int add_channel(zl_comp_t *comp, int fd) {
+  int rc = 0;
+  pthread_mutex_lock(&zl_context.reactor_lock);
+  if (zl_context.channel_count < MAX_CHANNEL_COUNT) {
+    zl_channel_t *channel = &zl_context.channels[zl_context.channel_count++];
+    channel->fd = fd;
+    channel->comp = comp;
+    channel->framer = calloc(1, sizeof(zl_line_framer_t));
+  } else {
+    rc = -1;
+  }
+  pthread_mutex_unlock(&zl_context.reactor_lock);
+  if (rc == 0) {
+    wakeup_reactor();
+  }
+  return rc;
+}
+
+static void remove_channel(int fd) {
+  pthread_mutex_lock(&zl_context.reactor_lock);
+  for (size_t i = 0; i < zl_context.channel_count; i++) {
+    if (zl_context.channels[i].fd == fd) {
+      zl_line_framer_t *framer = zl_context.channels[i].framer;
+      if (framer) {
+        free(framer->buffer);
+        free(framer);
+      }
+      zl_context.channels[i] = zl_context.channels[--zl_context.channel_count];
+      break;
+    }
+  }
+  pthread_mutex_unlock(&zl_context.reactor_lock);
+  close(fd);
+}
 
-  DEBUG("starting a component communication thread\n");
+static size_t get_pid_index_slot(pid_t pid) {
+  return ((unsigned int)pid * 2654435761u) & (PID_INDEX_SIZE - 1);
+}
 
-  zl_comp_t *comp = args;
+/**
+ * @brief Add a component PID to the index, the reactor lock must be held
+ */
+static void index_comp_pid(pid_t pid, zl_comp_t *comp) {
+  size_t slot = get_pid_index_slot(pid);
+  while (zl_context.pid_index[slot].comp) {
+    slot = (slot + 1) & (PID_INDEX_SIZE - 1);
+  }
+  zl_context.pid_index[slot].pid = pid;
+  zl_context.pid_index[slot].comp = comp;
+}
 
+/**
+ * @brief Remove a PID from the index, the reactor lock must be held
+ *
+ * @return zl_comp_t* the component the PID belonged to or NULL if unknown
+ */
+static zl_comp_t *unindex_comp_pid(pid_t pid) {
+  size_t slot = get_pid_index_slot(pid);
+  while (zl_context.pid_index[slot].comp && zl_context.pid_index[slot].pid != pid) {
+    slot = (slot + 1) & (PID_INDEX_SIZE - 1);
+  }
+  zl_comp_t *comp = zl_context.pid_index[slot].comp;
+  if (!comp) {
+    return NULL;
+  }
+  // shift back the entries of the probe sequence so that lookups still find them
+  size_t next = slot;
   while (true) {
+    next = (next + 1) & (PID_INDEX_SIZE - 1);
+    if (!zl_context.pid_index[next].comp) {
+      break;
+    }
+    size_t home = get_pid_index_slot(zl_context.pid_index[next].pid);
+    bool movable = next > slot ? (home <= slot || home > next) : (home <= slot && home > next);
+    if (movable) {
+      zl_context.pid_index[slot] = zl_context.pid_index[next];
+      slot = next;
+    }
+  }
+  zl_context.pid_index[slot].pid = 0;
+  zl_context.pid_index[slot].comp = NULL;
+  return comp;
+}
+
+/**
+ * @brief Reap all the terminated children and dispatch their exit to the
+ * owning components
+ */
+static void handle_child_exit(zl_comp_t *comp, pid_t pid, int status) {
+  if (comp && comp->pid == pid) {
+    comp->exit_status = status;
+    send_event(ZL_EVENT_COMP_EXIT, comp);
+  } else if (pid == zl_context.fork_server.pid) {
+    WARN(MSG_FORK_SERVER_ENDED, status);
+  } else {
+    DEBUG("reaped unknown child %d, status = %d\n", pid, status);
+  }
+}
 
+static void reap_children(void) {
+  while (true) {
     int comp_status = 0;
-    int wait_rc = waitpid(comp->pid, &comp_status, WNOHANG);
-    if (wait_rc == comp->pid) {
-      INFO(MSG_COMP_TERMINATED, comp->name, comp->pid, comp_status);
-      comp->pid = -1;
-      time_t uptime = time(NULL) - comp->start_time;
-      if (uptime > MIN_UPTIME_SECS) {
-        comp->fail_cnt = 1;
-      } else {
-        comp->fail_cnt++;
-      }
-      if (!comp->clean_stop) {
-        if (comp->fail_cnt <= comp->restart_intervals.count) {
-          size_t delay = comp->restart_intervals.data[comp->fail_cnt - 1];
-          INFO(MSG_NEXT_RESTART, comp->name, (int)delay);
-          sleep(delay);
-          send_event(ZL_EVENT_COMP_RESTART, comp);
-        } else {
-          ERROR(MSG_MAX_RETRIES_REACHED, comp->name);
+    pthread_mutex_lock(&zl_context.reactor_lock);
+    pid_t pid = waitpid(-1, &comp_status, WNOHANG);
+    zl_comp_t *comp = pid > 0 ? unindex_comp_pid(pid) : NULL;
+    if (pid > 0 && pid == zl_context.fork_server.pid) {
+      zl_context.fork_server.available = false;
+    }
+    pthread_mutex_unlock(&zl_context.reactor_lock);
+    if (pid <= 0) {
+      break;
+    }
+    handle_child_exit(comp, pid, comp_status);
+  }
+}
+
+/**
+ * @brief Dispatch the exit of the components forked by the fork server
+ *
+ * @return int -1 if the fork server has closed the pipe
+ */
+static int read_fork_server_exits(void) {
+  zl_fork_exit_t exits[16];
+  ssize_t len;
+  // the writes of the fork server are atomic, a read returns whole records
+  while ((len = read(zl_context.fork_server.exits, exits, sizeof(exits))) > 0) {
+    for (size_t i = 0; i < len / sizeof(exits[0]); i++) {
+      pthread_mutex_lock(&zl_context.reactor_lock);
+      zl_comp_t *comp = unindex_comp_pid(exits[i].pid);
+      if (!comp) {
+        // the fork request is still being answered, start_component() claims the exit
+        zl_fork_server_t *server = &zl_context.fork_server;
+        if (server->unclaimed_count == MAX_CHILD_COUNT) {
+          memmove(server->unclaimed, server->unclaimed + 1, (MAX_CHILD_COUNT - 1) * sizeof(server->unclaimed[0]));
+          server->unclaimed_count--;
         }
-      }else{
-        INFO(MSG_COMP_STOPPED, comp->name);
+        server->unclaimed[server->unclaimed_count++] = exits[i];
+      }
+      pthread_mutex_unlock(&zl_context.reactor_lock);
+      if (comp) {
+        handle_child_exit(comp, exits[i].pid, exits[i].status);
       }
+    }
+  }
+  return len == 0 ? -1 : 0;
+}
 
-      break;
-    } else if (wait_rc == -1) {
-      DEBUG("waitpid failed for %s(%d) - %s\n",
-            comp->name, comp->pid, strerror(errno));
-      break;
-    } else {
-      DEBUG("waitpid RC = 0 for %s(%d)\n", comp->name, comp->pid);
+/**
+ * @brief Take the exit of a forked component that the fork server has reported before the
+ * component was indexed, must be called with the reactor lock held
+ *
+ * @return bool true if the component has ended
+ */
+static bool claim_fork_exit(pid_t pid, int *status) {
+  zl_fork_server_t *server = &zl_context.fork_server;
+  for (size_t i = 0; i < server->unclaimed_count; i++) {
+    if (server->unclaimed[i].pid == pid) {
+      *status = server->unclaimed[i].status;
+      server->unclaimed[i] = server->unclaimed[--server->unclaimed_count];
+      return true;
+    }
+  }
+  return false;
+}
+
+static void handle_sigchld(int sig) {
+  int saved_errno = errno;
+  char signal_byte = WAKEUP_BYTE_IO;
+  write(zl_context.reactor_wakeup[1], &signal_byte, 1);
+  errno = saved_errno;
+}
+
+/**
+ * @brief Set up an embedded JavaScript engine for a zwe script with the modules configmgr gives
+ * its scripts. The script loads the configuration itself, like it does under configmgr. Only used
+ * in forked copies of the launcher, the engine ends with the process.
+ */
+static EmbeddedJS *init_script_engine(const char *script) {
+  EmbeddedJS *ejs = allocateEmbeddedJS(NULL);
+  if (!ejs) {
+    return NULL;
+  }
+  char *argv[] = {(char *)script, NULL};
+  EJSNativeModule *modules[] = {exportConfigManagerToEJS(ejs)};
+  if (!configureEmbeddedJS(ejs, modules, sizeof(modules) / sizeof(modules[0]), 1, argv)) {
+    return NULL;
+  }
+  return ejs;
+}
+
+static int send_fork_request(int socket, int comp_index, const int fds[2]) {
+  struct iovec iov = {&comp_index, sizeof(comp_index)};
+  char control[CMSG_SPACE(2 * sizeof(int))];
+  memset(control, 0, sizeof(control));
+  struct msghdr msg = {0};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(2 * sizeof(int));
+  memcpy(CMSG_DATA(cmsg), fds, 2 * sizeof(int));
+  ssize_t sent;
+  while ((sent = sendmsg(socket, &msg, 0)) == -1 && errno == EINTR);
+  return sent == sizeof(comp_index) ? 0 : -1;
+}
+
+/**
+ * @brief Receive the component index, stdin and stdout of a fork request
+ *
+ * @return int 1 if the launcher has closed the socket
+ */
+static int receive_fork_request(int socket, int *comp_index, int fds[2]) {
+  struct iovec iov = {comp_index, sizeof(*comp_index)};
+  char control[CMSG_SPACE(2 * sizeof(int))];
+  struct msghdr msg = {0};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t received;
+  while ((received = recvmsg(socket, &msg, 0)) == -1 && errno == EINTR);
+  if (received == 0) {
+    return 1;
+  }
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  if (received != sizeof(*comp_index) || !cmsg || cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(2 * sizeof(int))) {
+    return -1;
+  }
+  memcpy(fds, CMSG_DATA(cmsg), 2 * sizeof(int));
+  return 0;
+}
+
+/**
+ * @brief Fork a component in the fork server. The child runs the start script of the component in
+ * the engine set up by the fork server, as configmgr would.
+ *
+ * @return pid_t The PID of the component, -1 on failure
+ */
+static int fork_server_sigchld[2];
+
+static pid_t fork_component(EmbeddedJS *ejs, const char *script, zl_comp_t *comp, const int fds[2]) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(zl_context.fork_server.socket);
+    close(zl_context.fork_server.exits);
+    close(fork_server_sigchld[0]);
+    close(fork_server_sigchld[1]);
+    // a process group of its own like a spawned component, so that the whole tree can be terminated
+    setpgid(0, 0);
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGPIPE, SIG_DFL);
+    sigset_t no_signals;
+    sigemptyset(&no_signals);
+    sigprocmask(SIG_SETMASK, &no_signals, NULL);
+    dup2(fds[0], STDIN_FILENO);
+    dup2(fds[1], STDOUT_FILENO);
+    dup2(fds[1], STDERR_FILENO);
+    close(fds[0]);
+    close(fds[1]);
+    environ = (char **)comp->envp;
+    int status = ejsEvalFile(ejs, script, EJS_LOAD_IS_MODULE);
+    fflush(stdout);
+    fflush(stderr);
+    _exit(status == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+  if (pid != -1) {
+    // before the launcher can signal the group
+    setpgid(pid, pid);
+  }
+  return pid;
+}
+
+static void handle_fork_server_sigchld(int sig) {
+  int saved_errno = errno;
+  write(fork_server_sigchld[1], "C", 1);
+  errno = saved_errno;
+}
+
+/**
+ * @brief The loop of the fork server: fork a component for each request of the launcher and report
+ * the exit of the forked components, until the launcher closes the socket
+ */
+static void run_fork_server(void) {
+  int socket = zl_context.fork_server.socket;
+  char script[PATH_MAX];
+  snprintf(script, sizeof(script), "%s/bin/commands/internal/start/component/cli.js", zl_context.root_dir);
+
+  // the launcher stops the fork server by closing the socket
+  signal(SIGINT, SIG_IGN);
+  signal(SIGTERM, SIG_IGN);
+
+  EmbeddedJS *ejs = init_script_engine(script);
+  int ready = ejs && !pipe(fork_server_sigchld) ? 0 : -1;
+  if (ready == 0) {
+    for (int i = 0; i < 2; i++) {
+      fcntl(fork_server_sigchld[i], F_SETFL, O_NONBLOCK);
+      fcntl(fork_server_sigchld[i], F_SETFD, FD_CLOEXEC);
+    }
+    struct sigaction sa;
+    sa.sa_handler = handle_fork_server_sigchld;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    ready = sigaction(SIGCHLD, &sa, NULL);
+  }
+  if (write(socket, &ready, sizeof(ready)) != sizeof(ready) || ready) {
+    _exit(EXIT_FAILURE);
+  }
+
+  // the exits are queued, the fork server must keep answering while the launcher is busy
+  int exits = zl_context.fork_server.exits;
+  fcntl(exits, F_SETFL, O_NONBLOCK);
+  zl_fork_exit_t pending[MAX_CHILD_COUNT];
+  size_t pending_count = 0;
+
+  struct pollfd fds[3] = {{socket, POLLIN, 0}, {fork_server_sigchld[0], POLLIN, 0}, {exits, POLLOUT, 0}};
+  while (true) {
+    if (poll(fds, pending_count ? 3 : 2, -1) == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    if (fds[1].revents & POLLIN) {
+      char drain[64];
+      while (read(fork_server_sigchld[0], drain, sizeof(drain)) > 0);
+      zl_fork_exit_t exit_record;
+      // a component runs once at a time, there's no more exits than components
+      while (pending_count < MAX_CHILD_COUNT && (exit_record.pid = waitpid(-1, &exit_record.status, WNOHANG)) > 0) {
+        pending[pending_count++] = exit_record;
+      }
+    }
+
+    // a record is less than PIPE_BUF, it's written whole or not at all
+    size_t sent = 0;
+    while (sent < pending_count && write(exits, &pending[sent], sizeof(pending[0])) == sizeof(pending[0])) {
+      sent++;
+    }
+    memmove(pending, pending + sent, (pending_count - sent) * sizeof(pending[0]));
+    pending_count -= sent;
+
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+      int comp_index;
+      int comp_fds[2];
+      int rc = receive_fork_request(socket, &comp_index, comp_fds);
+      if (rc == 1) {
+        break;
+      }
+      pid_t reply[2] = {-1, EINVAL};
+      if (rc == 0) {
+        if (comp_index >= 0 && comp_index < (int)zl_context.child_count) {
+          reply[0] = fork_component(ejs, script, &zl_context.children[comp_index], comp_fds);
+          reply[1] = errno;
+        }
+        close(comp_fds[0]);
+        close(comp_fds[1]);
+      }
+      if (write(socket, reply, sizeof(reply)) != sizeof(reply)) {
+        break;
+      }
+    }
+  }
+  _exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Start the fork server if zowe.launcher.forkServer is true. It's a copy of the launcher
+ * made once the components are initialized, and it forks the components with the start script
+ * engine already set up. A start or a restart saves the exec of configmgr and the boot of the
+ * engine only, the start script still loads zowe.yaml and the schemas in each component.
+ * Components are started with spawn if the fork server isn't available. When the fork server ends,
+ * the components it forked are killed and handled like components that ended, see
+ * release_forked_comps().
+ */
+static void start_fork_server(void) {
+  bool enabled = false;
+  get_json_bool(get_config_value("zowe.launcher.forkServer"), &enabled);
+  if (!enabled) {
+    return;
+  }
+
+  int sockets[2];
+  int exits[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets)) {
+    WARN(MSG_FORK_SERVER_ERR, strerror(errno));
+    return;
+  }
+  if (pipe(exits)) {
+    WARN(MSG_FORK_SERVER_ERR, strerror(errno));
+    close(sockets[0]);
+    close(sockets[1]);
+    return;
+  }
+  // neither the components nor the commands the launcher runs get them
+  for (int i = 0; i < 2; i++) {
+    fcntl(sockets[i], F_SETFD, FD_CLOEXEC);
+    fcntl(exits[i], F_SETFD, FD_CLOEXEC);
+  }
+
+  // the fork server can't inherit the log writer thread
+  stop_log_writer();
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(sockets[0]);
+    close(exits[0]);
+    zl_context.fork_server.socket = sockets[1];
+    zl_context.fork_server.exits = exits[1];
+    run_fork_server();
+  }
+  start_log_writer();
+  close(sockets[1]);
+  close(exits[1]);
+  if (pid == -1) {
+    WARN(MSG_FORK_SERVER_ERR, strerror(errno));
+    close(sockets[0]);
+    close(exits[0]);
+    return;
+  }
+
+  int ready = -1;
+  ssize_t received;
+  while ((received = read(sockets[0], &ready, sizeof(ready))) == -1 && errno == EINTR);
+  if (received != sizeof(ready) || ready) {
+    WARN(MSG_FORK_SERVER_ERR, "the script engine can't be set up");
+    close(sockets[0]);
+    close(exits[0]);
+    waitpid(pid, NULL, 0);
+    return;
+  }
+
+  // a write to a fork server that has ended must fail instead of ending the launcher
+  signal(SIGPIPE, SIG_IGN);
+  fcntl(exits[0], F_SETFL, O_NONBLOCK);
+  zl_context.fork_server.pid = pid;
+  zl_context.fork_server.socket = sockets[0];
+  zl_context.fork_server.exits = exits[0];
+  zl_context.fork_server.available = true;
+  INFO(MSG_FORK_SERVER_STARTED, pid);
+}
+
+/**
+ * @brief Stop using the fork server and kill it. The components it forked are released when the
+ * reactor sees the end of the exits pipe.
+ */
+static void lose_fork_server(const char *reason) {
+  pthread_mutex_lock(&zl_context.reactor_lock);
+  zl_context.fork_server.available = false;
+  pthread_mutex_unlock(&zl_context.reactor_lock);
+  WARN(MSG_FORK_SERVER_ERR, reason);
+  if (zl_context.fork_server.pid != -1) {
+    kill(zl_context.fork_server.pid, SIGKILL);
+  }
+}
+
+/**
+ * @brief Ask the fork server to fork a component. Only the thread that handles the events starts
+ * components, so there's one request at a time, and the reactor keeps running while it waits.
+ * A fork server that doesn't answer within FORK_SERVER_REPLY_TIMEOUT is given up.
+ *
+ * @param fds stdin and stdout of the component
+ * @return pid_t The PID of the component, -1 if it has to be spawned
+ */
+static pid_t request_fork_server(zl_comp_t *comp, const int fds[2]) {
+  pthread_mutex_lock(&zl_context.reactor_lock);
+  bool available = zl_context.fork_server.available;
+  pthread_mutex_unlock(&zl_context.reactor_lock);
+  if (!available) {
+    return -1;
+  }
+  int socket = zl_context.fork_server.socket;
+  if (send_fork_request(socket, comp - zl_context.children, fds)) {
+    lose_fork_server(strerror(errno));
+    return -1;
+  }
+
+  struct pollfd reply_fd = {socket, POLLIN, 0};
+  uint64_t deadline = get_time_ms() + FORK_SERVER_REPLY_TIMEOUT;
+  int poll_rc;
+  do {
+    uint64_t now = get_time_ms();
+    poll_rc = now < deadline ? poll(&reply_fd, 1, (int)(deadline - now)) : 0;
+  } while (poll_rc == -1 && errno == EINTR);
+  if (poll_rc <= 0) {
+    lose_fork_server(poll_rc == 0 ? "no reply in time" : strerror(errno));
+    return -1;
+  }
+
+  pid_t reply[2] = {-1, 0};
+  ssize_t received;
+  while ((received = read(socket, reply, sizeof(reply))) == -1 && errno == EINTR);
+  if (received != sizeof(reply)) {
+    lose_fork_server(received == -1 ? strerror(errno) : "no reply");
+    return -1;
+  }
+  if (reply[0] == -1) {
+    DEBUG("fork server failed to fork %s - %s\n", comp->name, strerror(reply[1]));
+  }
+  return reply[0];
+}
+
+/**
+ * @brief Kill the components forked by a fork server that has ended and report them as ended,
+ * their exit can't be reported any more
+ */
+static void release_forked_comps(void) {
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    zl_comp_t *comp = &zl_context.children[i];
+    pthread_mutex_lock(&zl_context.reactor_lock);
+    zl_context.fork_server.available = false;
+    zl_context.fork_server.released = true;
+    pid_t pid = comp->pid;
+    bool released = comp->forked && pid > 0 && unindex_comp_pid(pid) == comp;
+    comp->forked = false;
+    pthread_mutex_unlock(&zl_context.reactor_lock);
+    if (released) {
+      WARN(MSG_FORK_SERVER_COMP, comp->name, pid);
+      kill(-pid, SIGKILL);
+      handle_child_exit(comp, pid, -1);
+    }
+  }
+}
+
+static void stop_fork_server(void) {
+  if (zl_context.fork_server.socket != -1) {
+    close(zl_context.fork_server.socket);
+    zl_context.fork_server.socket = -1;
+  }
+}
+
+static bool has_backlog(const zl_comp_t *comp) {
+  return comp->backlog.len > 0 || comp->backlog.spill_read < comp->backlog.spill_write;
+}
+
+/**
+ * @brief Check if the reactor has to stop reading the output of a component
+ */
+static bool is_backlog_full(const zl_comp_t *comp) {
+  const zl_output_backlog_t *backlog = &comp->backlog;
+  if (comp->output_policy != ZL_OUTPUT_BLOCK) {
+    return false;
+  }
+  // the spill file only starts over when it's drained, keep room for one more read
+  bool spill_full = backlog->spill_write + LINE_READ_SIZE_MAX >= (off_t)comp->output_spill_size;
+  if (backlog->spill_read < backlog->spill_write) {
+    // new output goes to the spill file until it's drained, whatever the memory buffer holds
+    return spill_full;
+  }
+  if (backlog->len < comp->output_buffer_size) {
+    return false;
+  }
+  return comp->output_spill_size == 0 || backlog->spill_failed || spill_full;
+}
+
+static void get_spill_path(const zl_comp_t *comp, char *path, size_t size) {
+  snprintf(path, size, "%s/%s/%s.spill", zl_context.workspace_dir, LAUNCHER_DIR, comp->name);
+}
+
+static int open_spill_file(zl_comp_t *comp) {
+  zl_output_backlog_t *backlog = &comp->backlog;
+  if (backlog->spill_fd != -1) {
+    return 0;
+  }
+  if (backlog->spill_failed || !zl_context.workspace_dir) {
+    return -1;
+  }
+  char path[PATH_MAX + 1];
+  snprintf(path, sizeof(path), "%s/%s", zl_context.workspace_dir, LAUNCHER_DIR);
+  if (mkdir_all(path, 0770) != 0) {
+    ERROR(MSG_COMP_SPILL_ERR, comp->name, path, strerror(errno));
+    backlog->spill_failed = true;
+    return -1;
+  }
+  get_spill_path(comp, path, sizeof(path));
+  backlog->spill_fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (backlog->spill_fd == -1) {
+    ERROR(MSG_COMP_SPILL_ERR, comp->name, path, strerror(errno));
+    backlog->spill_failed = true;
+    return -1;
+  }
+  return 0;
+}
+
+static void close_spill_file(zl_comp_t *comp) {
+  zl_output_backlog_t *backlog = &comp->backlog;
+  if (backlog->spill_fd != -1) {
+    char path[PATH_MAX + 1];
+    get_spill_path(comp, path, sizeof(path));
+    close(backlog->spill_fd);
+    unlink(path);
+    backlog->spill_fd = -1;
+  }
+}
+
+static void drop_comp_line(zl_comp_t *comp) {
+  zl_output_backlog_t *backlog = &comp->backlog;
+  atomic_fetch_add(&backlog->dropped_lines, 1);
+  if (!backlog->dropping) {
+    backlog->dropping = true;
+    WARN(MSG_COMP_OUTPUT_DROPPED, comp->name);
+  }
+}
+
+/**
+ * @brief Add a line to the backlog of a component, the line goes to memory
+ * until the buffer is full and to the spill file after that, so the backlog
+ * stays in order
+ */
+static void append_backlog(zl_comp_t *comp, const char *line, size_t len) {
+  zl_output_backlog_t *backlog = &comp->backlog;
+  size_t record_len = len + 1;
+  bool spilling = backlog->spill_read < backlog->spill_write;
+  bool spill_allowed = comp->output_spill_size > 0 && (size_t)backlog->spill_write + record_len <= comp->output_spill_size;
+
+  if (!spilling && backlog->len + record_len > comp->output_buffer_size && spill_allowed && !open_spill_file(comp)) {
+    char path[PATH_MAX + 1];
+    get_spill_path(comp, path, sizeof(path));
+    WARN(MSG_COMP_OUTPUT_SPILLED, comp->name, path);
+    spilling = true;
+  }
+
+  if (spilling) {
+    // the spilled output must be written before anything newer
+    if (!spill_allowed) {
+      drop_comp_line(comp);
+      return;
+    }
+    ssize_t written = pwrite(backlog->spill_fd, line, len, backlog->spill_write);
+    if (written == (ssize_t)len) {
+      written += pwrite(backlog->spill_fd, "\n", 1, backlog->spill_write + len);
+    }
+    if (written != (ssize_t)record_len) {
+      char path[PATH_MAX + 1];
+      get_spill_path(comp, path, sizeof(path));
+      ERROR(MSG_COMP_SPILL_ERR, comp->name, path, strerror(written == -1 ? errno : ENOSPC));
+      drop_comp_line(comp);
+      return;
+    }
+    backlog->spill_write += record_len;
+    atomic_fetch_add(&backlog->spilled_bytes, record_len);
+    atomic_fetch_add(&backlog->lag, record_len);
+    return;
+  }
+
+  if (backlog->len + record_len > comp->output_buffer_size && comp->output_policy == ZL_OUTPUT_DROP) {
+    drop_comp_line(comp);
+    return;
+  }
+  // with the block policy the buffer may exceed its size by one read, the
+  // reactor stops reading until the backlog shrinks
+  if (backlog->head + backlog->len + record_len > backlog->capacity) {
+    memmove(backlog->buffer, backlog->buffer + backlog->head, backlog->len);
+    backlog->head = 0;
+    if (backlog->len + record_len > backlog->capacity) {
+      size_t capacity = backlog->capacity ? backlog->capacity * 2 : LINE_READ_SIZE_INITIAL;
+      while (capacity < backlog->len + record_len) {
+        capacity *= 2;
+      }
+      char *buffer = realloc(backlog->buffer, capacity);
+      if (!buffer) {
+        drop_comp_line(comp);
+        return;
+      }
+      backlog->buffer = buffer;
+      backlog->capacity = capacity;
+    }
+  }
+  memcpy(backlog->buffer + backlog->head + backlog->len, line, len);
+  backlog->buffer[backlog->head + backlog->len + len] = '\n';
+  backlog->len += record_len;
+  atomic_fetch_add(&backlog->lag, record_len);
+}
+
+/**
+ * @brief Write the lines of a buffer to the log, stop when the log writer is full
+ *
+ * @return size_t number of bytes written
+ */
+static size_t drain_lines(const char *data, size_t len, bool wait) {
+  size_t done = 0;
+  const char *newline;
+  while ((newline = memchr(data + done, '\n', len - done))) {
+    size_t line_len = newline - (data + done);
+    if (!put_log_record(&zl_log_writer, -1, data + done, line_len, true, wait)) {
+      break;
+    }
+    done += line_len + 1;
+  }
+  return done;
+}
+
+/**
+ * @brief Write the backlog of a component to the log, in order
+ *
+ * @param wait Wait for the log writer instead of stopping when it is full
+ */
+static void drain_backlog(zl_comp_t *comp, bool wait) {
+  static char spill_chunk[OUTPUT_SPILL_READ_SIZE]; // only used by the reactor
+  zl_output_backlog_t *backlog = &comp->backlog;
+
+  if (backlog->len > 0) {
+    size_t done = drain_lines(backlog->buffer + backlog->head, backlog->len, wait);
+    backlog->head += done;
+    backlog->len -= done;
+    atomic_fetch_sub(&backlog->lag, done);
+    if (backlog->len > 0) {
+      return;
+    }
+    backlog->head = 0;
+  }
+
+  while (backlog->spill_read < backlog->spill_write) {
+    size_t chunk = backlog->spill_write - backlog->spill_read;
+    if (chunk > sizeof(spill_chunk)) {
+      chunk = sizeof(spill_chunk);
+    }
+    ssize_t chunk_len = pread(backlog->spill_fd, spill_chunk, chunk, backlog->spill_read);
+    if (chunk_len <= 0) {
+      char path[PATH_MAX + 1];
+      get_spill_path(comp, path, sizeof(path));
+      ERROR(MSG_COMP_SPILL_ERR, comp->name, path, strerror(chunk_len == -1 ? errno : EIO));
+      atomic_fetch_sub(&backlog->lag, backlog->spill_write - backlog->spill_read);
+      backlog->spill_read = backlog->spill_write;
+      break;
+    }
+    size_t done = drain_lines(spill_chunk, chunk_len, wait);
+    if (done == 0 && memchr(spill_chunk, '\n', chunk_len)) {
+      return; // the log writer is full
+    }
+    if (done == 0) {
+      done = chunk_len; // no line fits into a chunk, can't happen with the line length limit
+    }
+    backlog->spill_read += done;
+    atomic_fetch_sub(&backlog->lag, done);
+  }
+
+  if (backlog->spill_write > 0) {
+    // everything has been written, start the spill file over
+    ftruncate(backlog->spill_fd, 0);
+    backlog->spill_read = 0;
+    backlog->spill_write = 0;
+  }
+  backlog->dropping = false;
+}
+
+static void get_log_file_path(const zl_comp_t *comp, int generation, char *path, size_t size) {
+  if (generation == 0) {
+    snprintf(path, size, "%s/%s/%s.log", zl_context.workspace_dir, LOG_FILE_DIR, comp->name);
+  } else {
+    snprintf(path, size, "%s/%s/%s.log.%d", zl_context.workspace_dir, LOG_FILE_DIR, comp->name, generation);
+  }
+}
+
+static void fail_log_file(zl_comp_t *comp, int error) {
+  zl_log_file_t *log_file = &comp->log_file;
+  char path[PATH_MAX + 1];
+  get_log_file_path(comp, 0, path, sizeof(path));
+  ERROR(MSG_LOG_FILE_ERR, path, strerror(error));
+  if (log_file->fd != -1) {
+    close(log_file->fd);
+    log_file->fd = -1;
+  }
+  log_file->len = 0;
+  log_file->failed = true;
+}
+
+static int open_log_file(zl_comp_t *comp) {
+  zl_log_file_t *log_file = &comp->log_file;
+  if (!log_file->buffer) {
+    log_file->buffer = malloc(LOG_FILE_BUFFER_SIZE);
+    if (!log_file->buffer) {
+      fail_log_file(comp, ENOMEM);
+      return -1;
+    }
+  }
+  char path[PATH_MAX + 1];
+  get_log_file_path(comp, 0, path, sizeof(path));
+  log_file->fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0640);
+  struct stat info;
+  if (log_file->fd == -1 || fstat(log_file->fd, &info) != 0) {
+    fail_log_file(comp, errno);
+    return -1;
+  }
+  log_file->size = info.st_size;
+  log_file->opened = get_time_ms();
+  return 0;
+}
+
+static void flush_log_file(zl_comp_t *comp) {
+  zl_log_file_t *log_file = &comp->log_file;
+  if (log_file->len == 0 || log_file->fd == -1) {
+    return;
+  }
+  size_t done = 0;
+  while (done < log_file->len) {
+    ssize_t written = write(log_file->fd, log_file->buffer + done, log_file->len - done);
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fail_log_file(comp, errno);
+      return;
+    }
+    done += written;
+  }
+  atomic_fetch_add(&zl_file_writer.bytes_written, done);
+  log_file->size += done;
+  log_file->len = 0;
+  if (log_file->fsync == ZL_LOG_FSYNC_ALWAYS) {
+    fsync(log_file->fd);
+  }
+}
+
+static void close_log_file(zl_comp_t *comp) {
+  zl_log_file_t *log_file = &comp->log_file;
+  flush_log_file(comp);
+  if (log_file->fd != -1) {
+    if (log_file->fsync != ZL_LOG_FSYNC_NEVER) {
+      fsync(log_file->fd);
+    }
+    close(log_file->fd);
+    log_file->fd = -1;
+  }
+}
+
+/**
+ * @brief Close the log file and shift it to <name>.log.1, the oldest file over the retention is removed
+ */
+static void rotate_log_file(zl_comp_t *comp) {
+  zl_log_file_t *log_file = &comp->log_file;
+  close_log_file(comp);
+  char from[PATH_MAX + 1];
+  char to[PATH_MAX + 1];
+  for (int generation = log_file->retention; generation > 0; generation--) {
+    get_log_file_path(comp, generation - 1, from, sizeof(from));
+    get_log_file_path(comp, generation, to, sizeof(to));
+    rename(from, to);
+  }
+  if (log_file->retention == 0) {
+    get_log_file_path(comp, 0, from, sizeof(from));
+    unlink(from);
+  }
+  DEBUG("log file of %s rotated\n", comp->name);
+}
+
+static void append_log_file(zl_comp_t *comp, const char *data, size_t len) {
+  zl_log_file_t *log_file = &comp->log_file;
+  if (log_file->failed || (log_file->fd == -1 && open_log_file(comp))) {
+    return;
+  }
+  if (log_file->len + len > LOG_FILE_BUFFER_SIZE) {
+    flush_log_file(comp);
+  }
+  memcpy(log_file->buffer + log_file->len, data, len);
+  log_file->len += len;
+}
+
+static bool is_log_file_due(const zl_comp_t *comp, uint64_t now) {
+  const zl_log_file_t *log_file = &comp->log_file;
+  if (log_file->fd == -1 || log_file->size + log_file->len == 0) {
+    return false;
+  }
+  if (log_file->max_size && (size_t)log_file->size + log_file->len >= log_file->max_size) {
+    return true;
+  }
+  // the file may have been opened after now was taken
+  return log_file->max_age && now > log_file->opened && now - log_file->opened >= (uint64_t)log_file->max_age * 1000;
+}
+
+/**
+ * @brief The batch writer of zl_file_writer, the sink of a record is the index of the component
+ */
+static void write_file_batch(zl_log_writer_t *writer, struct iovec *iov, const int *sinks, int iov_count) {
+  uint64_t now = get_time_ms();
+  zl_comp_t *comp = NULL;
+  for (int i = 0; i < iov_count; i++) {
+    if (sinks[i] >= 0) {
+      comp = (size_t)sinks[i] < zl_context.child_count ? &zl_context.children[sinks[i]] : NULL;
+      // records are never split between two files
+      if (comp && is_log_file_due(comp, now)) {
+        rotate_log_file(comp);
+      }
+    }
+    if (comp) {
+      append_log_file(comp, iov[i].iov_base, iov[i].iov_len);
+    }
+  }
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    comp = &zl_context.children[i];
+    if (comp->log_file.enabled) {
+      flush_log_file(comp);
+      if (is_log_file_due(comp, now)) {
+        rotate_log_file(comp);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Start the file writer if any component has a log file, the output
+ * goes to stdout again if the writer can't be started
+ */
+static void start_file_writer(void) {
+  bool needed = false;
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    needed = needed || zl_context.children[i].log_file.enabled;
+  }
+  if (!needed) {
+    return;
+  }
+
+  char path[PATH_MAX + 1];
+  snprintf(path, sizeof(path), "%s/%s", zl_context.workspace_dir, LOG_FILE_DIR);
+  zl_file_writer.write_batch = write_file_batch;
+  if (mkdir_all(path, 0770) != 0 || start_writer(&zl_file_writer) != 0) {
+    ERROR(MSG_LOG_FILE_ERR, path, strerror(errno));
+    for (size_t i = 0; i < zl_context.child_count; i++) {
+      zl_context.children[i].log_file.enabled = false;
+      zl_context.children[i].sysprint = true;
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    zl_comp_t *comp = &zl_context.children[i];
+    if (comp->log_file.enabled) {
+      get_log_file_path(comp, 0, path, sizeof(path));
+      INFO(MSG_COMP_LOG_FILE, comp->name, path, comp->sysprint ? "yes" : "no");
+    }
+  }
+}
+
+/**
+ * @brief Stop the file writer and close the log files, the reactor must be stopped
+ */
+static void stop_file_writer(void) {
+  if (!zl_file_writer.write_batch) {
+    return;
+  }
+  stop_writer(&zl_file_writer);
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    if (zl_context.children[i].log_file.enabled) {
+      close_log_file(&zl_context.children[i]);
+    }
+  }
+}
+
+/**
+ * @brief Write component output to the log, or add it to the backlog if the
+ * log writer is full or the backlog isn't empty
+ *
+ * @param data Whole lines, the last one without its new line if add_newline is set
+ */
+static void write_comp_output(zl_comp_t *comp, const char *data, size_t len, bool add_newline) {
+  zl_log_file_t *log_file = &comp->log_file;
+  if (log_file->enabled) {
+    // the reactor never waits for the file system, the lines are dropped instead
+    if (!put_log_record(&zl_file_writer, comp - zl_context.children, data, len, add_newline, false)) {
+      unsigned long lines = add_newline ? 1 : 0;
+      for (const char *end = data + len, *p = data; (p = memchr(p, '\n', end - p)); p++) {
+        lines++;
+      }
+      unsigned long dropped = atomic_fetch_add(&log_file->dropped_lines, lines) + lines;
+      uint64_t now = get_time_ms();
+      if (!log_file->drop_reported || now - log_file->drop_reported >= LOG_FILE_DROP_REPORT_INTERVAL) {
+        log_file->drop_reported = now;
+        WARN(MSG_COMP_LOG_FILE_DROPPED, comp->name, dropped);
+      }
+    }
+  }
+  if (!comp->sysprint) {
+    return;
+  }
+  if (!has_backlog(comp) && try_write_log(data, len, add_newline)) {
+    return;
+  }
+  append_backlog(comp, data, add_newline ? len : len - 1);
+}
+
+static void write_comp_line(zl_comp_t *comp, const char *line, size_t len) {
+  write_comp_output(comp, line, len, true);
+}
+
+static bool contains_message_id(const char *line, size_t len, const char *id) {
+  size_t id_len = strlen(id);
+  for (size_t i = 0; i + id_len <= len; i++) {
+    if (line[i] == id[0] && !memcmp(line + i, id, id_len)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Let the supervisor know when a starting component prints its ready message
+ */
+static void check_for_ready_message(zl_comp_t *comp, const char *line, size_t len) {
+  if (!atomic_load_explicit(&comp->awaiting_ready, memory_order_relaxed)) {
+    return;
+  }
+  if (contains_message_id(line, len, comp->ready_message)) {
+    atomic_store(&comp->awaiting_ready, false);
+    send_event(ZL_EVENT_COMP_READY, comp);
+  }
+}
+
+/**
+ * @brief Print a complete line of component output and check it for sysMessages
+ * and the ready message
+ */
+static void print_comp_line(zl_comp_t *comp, const char *line, size_t len) {
+  if (len <= (size_t)comp->max_line_length) {
+    write_comp_line(comp, line, len);
+    check_for_and_print_sys_message(line, len);
+    check_for_ready_message(comp, line, len);
+    return;
+  }
+  // the line is cut at the limit and marked, this is rare so it may allocate
+  size_t marker_len = sizeof(LINE_TRUNCATED_MARKER) - 1;
+  char *truncated = malloc(comp->max_line_length + marker_len);
+  if (!truncated) {
+    return;
+  }
+  memcpy(truncated, line, comp->max_line_length);
+  memcpy(truncated + comp->max_line_length, LINE_TRUNCATED_MARKER, marker_len);
+  write_comp_line(comp, truncated, comp->max_line_length + marker_len);
+  check_for_and_print_sys_message(truncated, comp->max_line_length);
+  check_for_ready_message(comp, truncated, comp->max_line_length);
+  free(truncated);
+}
+
+static const char *find_last_newline(const char *data, size_t len) {
+  for (const char *c = data + len; c > data; c--) {
+    if (c[-1] == '\n') {
+      return c - 1;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Write whole lines of component output as large blocks, without looking at every line
+ *
+ * Used when no line has to be matched. The only per-line rule left is the
+ * line length limit: a block is cut at the last new line of every
+ * max_line_length window, so a window without a new line is the only place
+ * where a line is looked at.
+ *
+ * @param data Whole lines, ending with a new line
+ */
+static void write_comp_block(zl_comp_t *comp, const char *data, size_t len) {
+  const size_t line_max = comp->max_line_length + 1; // with its new line
+  const size_t record_max = LOG_RECORD_MAX_SLOTS * LOG_SLOT_SIZE;
+  while (len > 0) {
+    size_t block = 0;
+    while (block < len && block < record_max) {
+      size_t window = len - block;
+      if (window > line_max) {
+        window = line_max;
+      }
+      if (window > record_max - block) {
+        window = record_max - block;
+      }
+      if (block + window == len) {
+        block = len;
+        break;
+      }
+      const char *newline = find_last_newline(data + block, window);
+      if (!newline) {
+        break;
+      }
+      block = newline + 1 - data;
+    }
+    if (block == 0) {
+      // the first line is too long, it gets truncated
+      const char *newline = memchr(data, '\n', len);
+      print_comp_line(comp, data, newline - data);
+      block = newline + 1 - data;
+    } else {
+      write_comp_output(comp, data, block, false);
+    }
+    data += block;
+    len -= block;
+  }
+}
+
+/**
+ * @brief Read the output available on a component channel and print the complete lines
+ *
+ * @return int 0 if the channel is still open, -1 if it has to be closed
+ */
+static int read_comp_output(zl_channel_t *channel) {
+  zl_comp_t *comp = channel->comp;
+  zl_line_framer_t *framer = channel->framer;
+  if (!framer) {
+    ERROR(MSG_COMP_OUTPUT_ERR, comp->name, comp->pid, strerror(ENOMEM));
+    return -1;
+  }
+  if (!framer->read_size) {
+    framer->read_size = LINE_READ_SIZE_INITIAL;
+  }
+  if (framer->capacity < framer->len + framer->read_size) {
+    size_t capacity = framer->capacity ? framer->capacity : LINE_READ_SIZE_INITIAL;
+    while (capacity < framer->len + framer->read_size) {
+      capacity *= 2;
+    }
+    char *buffer = realloc(framer->buffer, capacity);
+    if (!buffer) {
+      ERROR(MSG_COMP_OUTPUT_ERR, comp->name, comp->pid, strerror(errno));
+      return -1;
+    }
+    framer->buffer = buffer;
+    framer->capacity = capacity;
+  }
+
+  ssize_t msg_len = read(channel->fd, framer->buffer + framer->len, framer->read_size);
+  if (msg_len > 0) {
+    // read more at once from a busy component, less from a quiet one
+    if ((size_t)msg_len == framer->read_size && framer->read_size < LINE_READ_SIZE_MAX) {
+      framer->read_size *= 2;
+    } else if ((size_t)msg_len < framer->read_size / 4 && framer->read_size > LINE_READ_SIZE_MIN) {
+      framer->read_size /= 2;
+    }
+
+    char *start = framer->buffer;
+    char *end = framer->buffer + framer->len + msg_len;
+    char *scan = framer->buffer + framer->len;
+    char *newline;
+    if (!zl_context.sys_messages && !framer->truncating && !atomic_load(&comp->awaiting_ready)) {
+      // passthrough, nothing has to be done per line
+      const char *last = find_last_newline(scan, end - scan);
+      if (last) {
+        write_comp_block(comp, start, last + 1 - start);
+        start = (char *)last + 1;
+      }
+      scan = end;
+    }
+    while ((newline = memchr(scan, '\n', end - scan))) {
+      if (framer->truncating) {
+        framer->truncating = false;
+      } else {
+        print_comp_line(comp, start, newline - start);
+      }
+      start = newline + 1;
+      scan = start;
+    }
+
+    size_t rest = end - start;
+    if (framer->truncating) {
+      rest = 0;
+    } else if (rest > (size_t)comp->max_line_length) {
+      print_comp_line(comp, start, rest);
+      framer->truncating = true;
+      rest = 0;
+    }
+    memmove(framer->buffer, start, rest);
+    framer->len = rest;
+    return 0;
+  }
+  if (msg_len == -1 && (errno == EAGAIN || errno == EINTR)) {
+    return 0;
+  }
+  if (msg_len == -1) {
+    ERROR(MSG_COMP_OUTPUT_ERR, comp->name, comp->pid, strerror(errno));
+  }
+  // the last line may have no new line
+  if (framer->len > 0 && !framer->truncating) {
+    print_comp_line(comp, framer->buffer, framer->len);
+  }
+  DEBUG("output of %s closed\n", comp->name);
+  return -1;
+}
+
+/**
+ * @brief The component I/O reactor: a single thread multiplexing the stdout
+ * pipes of all the components with poll(). It also reaps terminated
+ * components as soon as SIGCHLD wakes it up and turns a termination signal
+ * into an event for the supervisor.
+ */
+static void *handle_comp_output(void *args) {
+
+  DEBUG("starting the component I/O reactor\n");
+
+  // SIGCHLD is blocked in the other threads, it must interrupt this one only
+  sigset_t sigchld_set;
+  sigemptyset(&sigchld_set);
+  sigaddset(&sigchld_set, SIGCHLD);
+  pthread_sigmask(SIG_UNBLOCK, &sigchld_set, NULL);
+
+  struct pollfd fds[MAX_CHANNEL_COUNT + 2];
+  zl_channel_t channels[MAX_CHANNEL_COUNT];
+
+  while (!zl_context.reactor_stop) {
+
+    pthread_mutex_lock(&zl_context.reactor_lock);
+    size_t channel_count = zl_context.channel_count;
+    memcpy(channels, zl_context.channels, channel_count * sizeof(zl_channel_t));
+    pthread_mutex_unlock(&zl_context.reactor_lock);
+
+    fds[0].fd = zl_context.reactor_wakeup[0];
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    for (size_t i = 0; i < channel_count; i++) {
+      // poll() skips negative descriptors, a component with a full backlog
+      // blocks on its pipe until the log writer catches up
+      fds[i + 1].fd = is_backlog_full(channels[i].comp) ? -1 : channels[i].fd;
+      fds[i + 1].events = POLLIN;
+      fds[i + 1].revents = 0;
+    }
+
+    nfds_t fd_count = channel_count + 1;
+    if (zl_context.fork_server.exits != -1) {
+      fds[fd_count].fd = zl_context.fork_server.exits;
+      fds[fd_count].events = POLLIN;
+      fds[fd_count].revents = 0;
+      fd_count++;
+    }
+
+    bool backlog = false;
+    for (size_t i = 0; i < zl_context.child_count; i++) {
+      backlog = backlog || has_backlog(&zl_context.children[i]);
+    }
+
+    int poll_rc = poll(fds, fd_count, backlog ? OUTPUT_DRAIN_INTERVAL_MS : -1);
+    if (poll_rc == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ERROR(MSG_REACTOR_ERR, strerror(errno));
+      break;
     }
 
-    char msg[4096];
-    int retries_left = 3;
-    while (retries_left > 0) {
-
-      int msg_len = read(comp->output, msg, sizeof(msg));
-      if (msg_len > 0) {
-        msg[msg_len] = '\0';
-
-        char *next_line = strtok(msg, "\n");
+    if (fds[0].revents & POLLIN) {
+      char drain[64];
+      int drain_len;
+      while ((drain_len = read(zl_context.reactor_wakeup[0], drain, sizeof(drain))) > 0) {
+        if (memchr(drain, WAKEUP_BYTE_TERM, drain_len)) {
+          INFO(MSG_LAUNCHER_STOPING);
+          send_event(ZL_EVENT_TERM, NULL);
+        }
+      }
+    }
 
-        while (next_line) {
-          printf("%s\n", next_line);
-          check_for_and_print_sys_message(next_line); 
-          next_line = strtok(NULL, "\n");
+    for (size_t i = 0; i < channel_count; i++) {
+      if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) {
+        if (read_comp_output(&channels[i])) {
+          remove_channel(channels[i].fd);
         }
+      }
+    }
 
-        retries_left = 3;
-      } else if (msg_len == -1 && errno == EAGAIN) {
-        sleep(1);
-        retries_left--;
-        DEBUG("waiting for next message from %s(%d)\n", comp->name, comp->pid);
-      } else {
-        ERROR(MSG_COMP_OUTPUT_ERR, comp->name, comp->pid, strerror(errno));
+    if (fd_count > channel_count + 1 && (fds[channel_count + 1].revents & (POLLIN | POLLHUP | POLLERR))) {
+      if (read_fork_server_exits()) {
+        close(zl_context.fork_server.exits);
+        zl_context.fork_server.exits = -1;
+        release_forked_comps();
       }
+    }
 
+    for (size_t i = 0; i < zl_context.child_count; i++) {
+      if (has_backlog(&zl_context.children[i])) {
+        drain_backlog(&zl_context.children[i], false);
+      }
     }
 
+    reap_children();
+  }
+
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    drain_backlog(&zl_context.children[i], true);
+    close_spill_file(&zl_context.children[i]);
   }
 
+  DEBUG("component I/O reactor stopped\n");
+
   return NULL;
 }
 
-/**
- * @brief Copy environment variables + _BPX_SHAREAS for the specified component
- * 
- * @param comp The component
- * @return const char** environment strings list
- */
-static const char **env_comp(zl_comp_t *comp) {
-  const char *shareas = get_shareas_env(comp);
+static int start_reactor_thread(void) {
+
+  DEBUG("starting reactor thread\n");
+
+  if (pthread_mutex_init(&zl_context.reactor_lock, NULL) != 0) {
+    DEBUG("pthread_mutex_init() for reactor - %s\n", strerror(errno));
+    return -1;
+  }
 
-  int env_records = 0;
-  for (char **env = shared_uss_env; *env != 0; env++) {
-    env_records++;
+  if (pipe(zl_context.reactor_wakeup)) {
+    DEBUG("pipe() for reactor - %s\n", strerror(errno));
+    return -1;
   }
 
-  const char **env_comp = malloc((env_records + 3) * sizeof(char*));
+  if (fcntl(zl_context.reactor_wakeup[0], F_SETFL, O_NONBLOCK) ||
+      fcntl(zl_context.reactor_wakeup[1], F_SETFL, O_NONBLOCK)) {
+    DEBUG("fcntl() for reactor - %s\n", strerror(errno));
+    return -1;
+  }
 
-  char *componentEnv = malloc(256);
-  snprintf(componentEnv, 256, "ZWE_CLI_PARAMETER_COMPONENT=%s", comp->name);
+  // the threads created from now on inherit the mask, only the reactor unblocks SIGCHLD
+  sigset_t sigchld_set;
+  sigemptyset(&sigchld_set);
+  sigaddset(&sigchld_set, SIGCHLD);
+  pthread_sigmask(SIG_BLOCK, &sigchld_set, NULL);
 
+  struct sigaction sa;
+  sa.sa_handler = handle_sigchld;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+  if (sigaction(SIGCHLD, &sa, NULL) == -1) {
+    DEBUG("failed to set SIGCHLD handler - %s\n", strerror(errno));
+    return -1;
+  }
 
-  int i = 0;
-  env_comp[i++] = shareas;
-  env_comp[i++] = componentEnv;
-  for (char **env = shared_uss_env; *env != 0 && i < env_records; env++) {
-    char *thisEnv = *env;
-    char *aux = malloc(strlen(thisEnv) + 1);
-    strncpy(aux, thisEnv, strlen(thisEnv));
-    aux[strlen(thisEnv)] = '\0';
-    trimRight(aux, strlen(aux));
-    env_comp[i] = aux;
-    i++;
+  if (pthread_create(&zl_context.reactor_thid, NULL, handle_comp_output, NULL) != 0) {
+    DEBUG("pthread_create() for reactor - %s\n", strerror(errno));
+    return -1;
   }
-  env_comp[i] = NULL;
-  return env_comp;
+  zl_context.reactor_running = true;
+
+  return 0;
+}
+
+static int stop_reactor_thread(void) {
+
+  zl_context.reactor_stop = true;
+  zl_context.reactor_running = false;
+  wakeup_reactor();
+
+  if (pthread_join(zl_context.reactor_thid, NULL) != 0) {
+    DEBUG("pthread_join() for reactor - %s\n", strerror(errno));
+    return -1;
+  }
+
+  DEBUG("reactor thread stopped\n");
+
+  return 0;
 }
 
 static int start_component(zl_comp_t *comp) {
@@ -915,14 +3855,25 @@ static int start_component(zl_comp_t *comp) {
     return -1;
   }
 
+  if (!comp->envp) {
+    DEBUG("environment of component %s not built\n", comp->name);
+    return -1;
+  }
+
   DEBUG("about to start component %s\n", comp->name);
 
   // ensure the new process has its own process group ID so we can terminate
   // the entire process tree
   struct inheritance inherit = {
-      .flags = (short) SPAWN_SETGROUP,
+      .flags = (short) (SPAWN_SETGROUP | SPAWN_SETSIGMASK),
       .pgroup = SPAWN_NEWPGROUP,
   };
+  // SIGCHLD is blocked in the launcher threads, don't pass that on to the component
+  sigemptyset(&inherit.sigmask);
+  // SIGPIPE is ignored in the launcher if the fork server runs
+  inherit.flags |= SPAWN_SETSIGDEF;
+  sigemptyset(&inherit.sigdefault);
+  sigaddset(&inherit.sigdefault, SIGPIPE);
 
   FILE *script = NULL;
   int c_stdout[2];
@@ -964,7 +3915,7 @@ static int start_component(zl_comp_t *comp) {
     NULL
   };
 
-  const char **c_envp = env_comp(comp);
+  const char **c_envp = comp->envp;
 
   if (zl_context.config.debug_mode) {
     DEBUG("params for %s:\n", bin);
@@ -980,144 +3931,537 @@ static int start_component(zl_comp_t *comp) {
     }
   }
 
-  comp->pid = spawn(bin, fd_count, fd_map, &inherit, c_args, c_envp);
+  pid_t forked_pid = request_fork_server(comp, fd_map);
+
+  // the reaper must not see the PID before it is indexed
+  pthread_mutex_lock(&zl_context.reactor_lock);
+  int forked_status = 0;
+  bool forked_ended = false;
+  bool forked_released = false;
+  comp->pid = forked_pid;
+  comp->forked = forked_pid != -1;
+  if (comp->forked) {
+    // the fork server may have reported the exit or ended since it replied
+    forked_ended = claim_fork_exit(forked_pid, &forked_status);
+    forked_released = !forked_ended && zl_context.fork_server.released;
+  } else {
+    comp->pid = spawn(bin, fd_count, fd_map, &inherit, c_args, c_envp);
+  }
+  if (comp->pid != -1 && !forked_ended && !forked_released) {
+    index_comp_pid(comp->pid, comp);
+  }
+  pthread_mutex_unlock(&zl_context.reactor_lock);
+
+  // the launcher must not keep the write end of the pipe, otherwise the
+  // reactor never sees the end of the component output
+  for (int i = 0; i < fd_count; i++) {
+    close(fd_map[i]);
+  }
+  close(c_stdout[1]);
+
   if (comp->pid == -1) {
     DEBUG("spawn() failed for %s - %s\n", comp->name, strerror(errno));
+    close(c_stdout[0]);
     return -1;
   }
 
-  comp->start_time = time(NULL);
+  comp->start_time = get_time_ms();
   comp->output = c_stdout[0];
-  close(c_stdout[1]);
 
   comp->clean_stop = false;
 
   INFO(MSG_COMP_STARTED, comp->name);
 
-  if (pthread_create(&comp->comm_thid, NULL, handle_comp_comm, comp) != 0) {
-    DEBUG("comm thread not started for %s - %s\n", comp->name, strerror(errno));
+  if (forked_released) {
+    WARN(MSG_FORK_SERVER_COMP, comp->name, comp->pid);
+    kill(-comp->pid, SIGKILL);
+    handle_child_exit(comp, comp->pid, -1);
+  } else if (forked_ended) {
+    handle_child_exit(comp, comp->pid, forked_status);
+  }
+
+  if (add_channel(comp, comp->output)) {
+    DEBUG("output of %s not registered with the reactor, too many channels\n", comp->name);
+    close(comp->output);
     return -1;
   }
 
   return 0;
 }
 
-static int start_components(void) {
+static bool is_startup_pending(const zl_comp_t *comp) {
+  return comp->startup_state == ZL_STARTUP_WAITING || comp->startup_state == ZL_STARTUP_STARTING;
+}
 
-  INFO(MSG_STARTING_COMPS);
+static bool are_dependencies_resolved(const zl_comp_t *comp) {
+  for (int i = 0; i < comp->dependency_count; i++) {
+    if (is_startup_pending(&zl_context.children[comp->dependencies[i]])) {
+      return false;
+    }
+  }
+  return true;
+}
 
-  int rc = 0;
+static void resolve_comp_startup(zl_comp_t *comp, int state) {
+  cancel_timer(&zl_context.timers, &comp->ready_timer);
+  atomic_store(&comp->awaiting_ready, false);
+  comp->startup_state = state;
+  comp->ready_time = get_time_ms() - zl_context.startup_begin;
+}
+
+/**
+ * @brief Log the chain of components that has determined how long the startup took,
+ * walking back from the last component to be ready through the prerequisites that
+ * were the last to be ready
+ */
+static void print_critical_path(void) {
+  int last = -1;
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    if (last == -1 || zl_context.children[i].ready_time >= zl_context.children[last].ready_time) {
+      last = i;
+    }
+  }
+  if (last == -1) {
+    return;
+  }
+
+  int path[MAX_CHILD_COUNT];
+  size_t path_len = 0;
+  for (int i = last; i != -1 && path_len < MAX_CHILD_COUNT; i = zl_context.children[i].critical_dependency) {
+    path[path_len++] = i;
+  }
+
+  char buf[CRITICAL_PATH_LENGTH] = {0};
+  int pos = 0;
+  for (size_t i = path_len; i > 0 && pos < (int)sizeof(buf); i--) {
+    zl_comp_t *comp = &zl_context.children[path[i - 1]];
+    pos += snprintf(buf + pos, sizeof(buf) - pos, "%s%s (%lu ms)", i == path_len ? "" : " -> ",
+                    comp->name, (unsigned long)comp->ready_time);
+  }
+  INFO(MSG_STARTUP_PATH, (unsigned long)zl_context.children[last].ready_time, buf);
+}
+
+static void check_startup_complete(void) {
+
+  if (zl_context.startup_done) {
+    return;
+  }
 
+  bool failed = false;
   for (size_t i = 0; i < zl_context.child_count; i++) {
-    if (start_component(&zl_context.children[i])) {
-      ERROR(MSG_COMP_START_FAILED, zl_context.children[i].name);
-      rc = -1;
+    zl_comp_t *comp = &zl_context.children[i];
+    if (is_startup_pending(comp)) {
+      return;
     }
+    failed |= comp->startup_state == ZL_STARTUP_FAILED;
   }
 
-  if (rc) {
+  zl_context.startup_done = true;
+  if (failed) {
     WARN(MSG_NOT_ALL_STARTED);
   } else {
     INFO(MSG_COMPS_STARTED);
   }
+  print_critical_path();
+}
 
-  return rc;
+/**
+ * @brief Start a component whose prerequisites are resolved. A component without a
+ * ready message is ready as soon as it is started.
+ */
+static void begin_comp_startup(zl_comp_t *comp) {
+
+  comp->startup_state = ZL_STARTUP_STARTING;
+  comp->critical_dependency = -1;
+  for (int i = 0; i < comp->dependency_count; i++) {
+    zl_comp_t *dependency = &zl_context.children[comp->dependencies[i]];
+    if (dependency->startup_state != ZL_STARTUP_READY) {
+      WARN(MSG_DEP_NOT_READY, comp->name, dependency->name);
+    }
+    if (comp->critical_dependency == -1 ||
+        dependency->ready_time > zl_context.children[comp->critical_dependency].ready_time) {
+      comp->critical_dependency = comp->dependencies[i];
+    }
+  }
+
+  if (comp->ready_message[0]) {
+    // set before the spawn, the first line of output can be the ready message
+    atomic_store(&comp->awaiting_ready, true);
+    if (comp->ready_timeout > 0) {
+      arm_timer(&zl_context.timers, &comp->ready_timer, get_time_ms(), (uint64_t)comp->ready_timeout * 1000);
+    }
+  }
+
+  if (start_component(comp)) {
+    ERROR(MSG_COMP_START_FAILED, comp->name);
+    resolve_comp_startup(comp, ZL_STARTUP_FAILED);
+  } else if (!comp->ready_message[0]) {
+    resolve_comp_startup(comp, ZL_STARTUP_READY);
+  }
+}
+
+/**
+ * @brief Start every waiting component whose prerequisites are ready, as long as
+ * fewer than zowe.launcher.startupConcurrency components are starting
+ */
+static void start_ready_components(void) {
+
+  if (zl_context.shutting_down) {
+    return;
+  }
+
+  bool progress;
+  do {
+    progress = false;
+    int starting = 0;
+    for (size_t i = 0; i < zl_context.child_count; i++) {
+      starting += zl_context.children[i].startup_state == ZL_STARTUP_STARTING;
+    }
+    for (size_t i = 0; i < zl_context.child_count; i++) {
+      zl_comp_t *comp = &zl_context.children[i];
+      if (zl_context.startup_concurrency > 0 && starting >= zl_context.startup_concurrency) {
+        break;
+      }
+      if (comp->startup_state != ZL_STARTUP_WAITING || !are_dependencies_resolved(comp)) {
+        continue;
+      }
+      begin_comp_startup(comp);
+      if (comp->startup_state == ZL_STARTUP_STARTING) {
+        starting++;
+      } else {
+        // its dependents may be startable now, look at the whole list again
+        progress = true;
+      }
+    }
+  } while (progress);
+
+  check_startup_complete();
+}
+
+/**
+ * @brief The component is no longer waited for, the components that depend on it
+ * are started anyway
+ */
+static void abandon_comp_startup(zl_comp_t *comp) {
+  if (comp->startup_state == ZL_STARTUP_STARTING || comp->startup_state == ZL_STARTUP_WAITING) {
+    resolve_comp_startup(comp, ZL_STARTUP_FAILED);
+    start_ready_components();
+  }
+}
+
+static void handle_comp_ready(zl_comp_t *comp) {
+
+  if (comp->startup_state != ZL_STARTUP_STARTING) {
+    return;
+  }
+
+  resolve_comp_startup(comp, ZL_STARTUP_READY);
+  INFO(MSG_COMP_READY, comp->name, (unsigned long)(get_time_ms() - comp->start_time));
+  start_ready_components();
+}
+
+static void handle_ready_timeout(zl_timer_t *timer) {
+
+  zl_comp_t *comp = timer->data;
+  if (comp->startup_state != ZL_STARTUP_STARTING) {
+    return;
+  }
+
+  WARN(MSG_COMP_NOT_READY, comp->name, comp->ready_timeout);
+  abandon_comp_startup(comp);
+}
+
+/**
+ * @brief Start the components in the order of their dependencies. Components without
+ * pending prerequisites are started at once, the others as the supervisor learns that
+ * their prerequisites are ready.
+ */
+static void start_components(void) {
+
+  INFO(MSG_STARTING_COMPS);
+
+  zl_context.startup_begin = get_time_ms();
+  start_ready_components();
+}
+
+/**
+ * @brief Send SIGTERM to a component and its children, SIGKILL follows after its grace period
+ */
+static int signal_comp_stop(zl_comp_t *comp) {
+
+  comp->stop_pending = false;
+  comp->kill_sent = false;
+  comp->stop_begin = get_time_ms();
+
+  DEBUG("about to stop component %s(%d) and its children, grace period = %d ms\n",
+        comp->name, comp->pid, comp->grace_period);
+
+  // the component is reported as stopped when its exit event arrives
+  arm_timer(&zl_context.timers, &comp->stop_timer, comp->stop_begin, comp->grace_period);
+
+  pid_t pgid = -comp->pid;
+  if (kill(pgid, SIGTERM)) {
+    ERROR("kill() failed for %s - %s\n", comp->name, strerror(errno));
+    return -1;
+  }
+
+  return 0;
 }
 
 static int stop_component(zl_comp_t *comp) {
 
+  comp->restart_requested = false;
+
+  if (comp->startup_state == ZL_STARTUP_WAITING || comp->startup_state == ZL_STARTUP_STARTING) {
+    DEBUG("component %s stopped before it is ready, its dependents don't wait for it\n", comp->name);
+    abandon_comp_startup(comp);
+  }
+
+  if (is_timer_armed(&comp->restart_timer)) {
+    DEBUG("pending restart of component %s cancelled\n", comp->name);
+    cancel_timer(&zl_context.timers, &comp->restart_timer);
+    INFO(MSG_COMP_STOPPED, comp->name);
+  }
+
   if (comp->pid == -1) {
     return 0;
   }
 
   comp->clean_stop = true;
 
-  DEBUG("about to stop component %s(%d) and its children\n",
-        comp->name, comp->pid);
+  return signal_comp_stop(comp);
+}
+
+static void check_shutdown_complete(void);
+static void stop_ready_components(void);
 
+/**
+ * @brief Give up on a component that hasn't exited after SIGKILL, its exit isn't waited for any more
+ */
+static void abandon_comp_stop(zl_comp_t *comp) {
+
+  WARN(MSG_COMP_NOT_STOPPED, comp->name, comp->pid);
+  comp->pid = -1;
+  if (zl_context.shutting_down) {
+    zl_context.shutdown_forced = true;
+    stop_ready_components();
+    check_shutdown_complete();
+  }
+}
+
+static void handle_stop_timeout(zl_timer_t *timer) {
+
+  zl_comp_t *comp = timer->data;
+  if (comp->pid <= 0) {
+    return;
+  }
+
+  if (comp->kill_sent) {
+    abandon_comp_stop(comp);
+    return;
+  }
+
+  DEBUG("Component %s(%d) is not shutting down within %d milliseconds\n",
+        comp->name, comp->pid, comp->grace_period);
+  WARN(MSG_NOT_SIGTERM_STOPPED, comp->name, comp->pid);
+  if (zl_context.shutting_down) {
+    zl_context.shutdown_forced = true;
+  }
   pid_t pgid = -comp->pid;
-  if (kill(pgid, SIGTERM)) {
+  if (kill(pgid, SIGKILL)) {
     ERROR("kill() failed for %s - %s\n", comp->name, strerror(errno));
-    return -1;
+    if (errno == ESRCH) {
+      // the process group is gone, the exit will not be reported
+      abandon_comp_stop(comp);
+      return;
+    }
   }
+  comp->kill_sent = true;
+  arm_timer(&zl_context.timers, &comp->stop_timer, get_time_ms(), SHUTDOWN_KILL_WAIT);
+}
+
+static void handle_restart_timer(zl_timer_t *timer) {
 
-  int wait_time = 0;
-  while (comp->pid > 0 && wait_time < SHUTDOWN_GRACEFUL_PERIOD) {
-    usleep(SHUTDOWN_POLLING_INTERVAL * 1000);
-    wait_time += SHUTDOWN_POLLING_INTERVAL;
+  zl_comp_t *comp = timer->data;
+  if (start_component(comp)) {
+    ERROR(MSG_COMP_RESTART_FAILED, comp->name);
+    abandon_comp_startup(comp);
   }
-  
-  if (comp->pid > 0) {
-    DEBUG("Component %s(%d) is not shutting down within %d milliseconds\n", 
-          comp->name, comp->pid, SHUTDOWN_GRACEFUL_PERIOD);
-    WARN(MSG_NOT_SIGTERM_STOPPED, comp->name, comp->pid);
-    pid_t pgid = -comp->pid;
-    if (kill(pgid, SIGKILL)) {
-      ERROR("kill() failed for %s - %s\n", comp->name, strerror(errno));
-      return -1;
+}
+
+static void finish_shutdown(void) {
+
+  if (zl_context.shutdown_forced) {
+    WARN(MSG_NOT_ALL_STOPPED);
+  } else {
+    INFO(MSG_COMPS_STOPPED);
+  }
+  INFO(MSG_SHUTDOWN_TIME, (unsigned long)(get_time_ms() - zl_context.shutdown_begin));
+
+  zl_context.shutdown_done = true;
+}
+
+static void check_shutdown_complete(void) {
+
+  if (zl_context.shutdown_done) {
+    return;
+  }
+
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    if (zl_context.children[i].pid > 0) {
+      return;
     }
   }
 
-  comp->pid = -1;
-  INFO(MSG_COMP_STOPPED, comp->name);
+  finish_shutdown();
+}
 
-  return 0;
+/**
+ * @brief Check if a component has to wait for others to stop: the running components with a lower
+ * launcher.stopOrder, and with the same one the components that depend on it
+ */
+static bool is_stop_blocked(const zl_comp_t *comp) {
+  int index = comp - zl_context.children;
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    const zl_comp_t *other = &zl_context.children[i];
+    if (other == comp || other->pid <= 0) {
+      continue;
+    }
+    if (other->stop_order < comp->stop_order) {
+      return true;
+    }
+    if (other->stop_order == comp->stop_order) {
+      for (int j = 0; j < other->dependency_count; j++) {
+        if (other->dependencies[j] == index) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
 }
 
-static int stop_components(void) {
+/**
+ * @brief Signal the components that nothing running has to wait for, all at once
+ */
+static void stop_ready_components(void) {
+  char names[CRITICAL_PATH_LENGTH] = {0};
+  size_t len = 0;
+  zl_comp_t *ready[MAX_CHILD_COUNT];
+  size_t ready_count = 0;
 
-  INFO(MSG_STOPING_COMPS);
-  prevent_restart=true;
+  // decided before signalling, so that the components of one phase are stopped together
+  for (size_t i = 0; i < zl_context.child_count; i++) {
+    zl_comp_t *comp = &zl_context.children[i];
+    if (comp->stop_pending && comp->pid > 0 && !is_stop_blocked(comp)) {
+      ready[ready_count++] = comp;
+    }
+  }
+  if (ready_count == 0) {
+    return;
+  }
+  for (size_t i = 0; i < ready_count; i++) {
+    int written = snprintf(names + len, sizeof(names) - len, "%s%s", i ? "," : "", ready[i]->name);
+    if (written > 0 && len + written < sizeof(names)) {
+      len += written;
+    }
+  }
+  INFO(MSG_STOP_PHASE, names);
+  for (size_t i = 0; i < ready_count; i++) {
+    if (signal_comp_stop(ready[i])) {
+      WARN("component %s not signalled, waiting for its grace period\n", ready[i]->name);
+    }
+  }
+}
 
-  int rc = 0;
+/**
+ * @brief Stop all the components in phases: by launcher.stopOrder, then in the reverse order of
+ * their dependencies. The components of a phase are signalled together, and the next phase begins
+ * as soon as they have exited. The shutdown is complete when the last component has exited or has
+ * been given up after SIGKILL.
+ */
+static void stop_components(void) {
+
+  INFO(MSG_STOPING_COMPS);
+  prevent_restart = true;
+  zl_context.shutting_down = true;
+  zl_context.shutdown_begin = get_time_ms();
 
   for (size_t i = 0; i < zl_context.child_count; i++) {
     zl_comp_t *comp = &zl_context.children[i];
+    cancel_timer(&zl_context.timers, &comp->restart_timer);
+    comp->restart_requested = false;
     comp->clean_stop = true;
-    if (comp->pid != -1) {
-      DEBUG("about to send SIGTERM to component %s(%d)\n", comp->name, comp->pid); 
-      pid_t pgid = -comp->pid;
-      if (kill(pgid, SIGTERM)) {
-        WARN("kill() failed for %s - %s\n", comp->name, strerror(errno));
-      }
-    }
+    // a component already stopping keeps its timer
+    comp->stop_pending = comp->pid != -1 && !is_timer_armed(&comp->stop_timer);
   }
 
-  int wait_time = 0;
-  bool all_exit = false;
-  while (!all_exit  && wait_time < SHUTDOWN_GRACEFUL_PERIOD) {
-    all_exit = true;
-    for (size_t i = 0; i < zl_context.child_count; i++) {
-      zl_comp_t *comptout = &zl_context.children[i];
-      if (comptout->pid > 0) {
-        all_exit = false;
+  stop_ready_components();
+  check_shutdown_complete();
+}
+
+static void handle_comp_exit(zl_comp_t *comp) {
+
+  INFO(MSG_COMP_TERMINATED, comp->name, comp->pid, comp->exit_status);
+  comp->pid = -1;
+  comp->stop_pending = false;
+  if (is_timer_armed(&comp->stop_timer)) {
+    cancel_timer(&zl_context.timers, &comp->stop_timer);
+    DEBUG("component %s stopped in %lu ms\n", comp->name, (unsigned long)(get_time_ms() - comp->stop_begin));
+  }
+
+  uint64_t uptime = get_time_ms() - comp->start_time;
+  if (uptime > (uint64_t)comp->min_uptime * 1000) {
+    comp->fail_cnt = 1;
+  } else {
+    comp->fail_cnt++;
+  }
+
+  if (comp->clean_stop) {
+    INFO(MSG_COMP_STOPPED, comp->name);
+    if (comp->restart_requested && !prevent_restart) {
+      comp->restart_requested = false;
+      comp->fail_cnt = 0;
+      if (start_component(comp)) {
+        ERROR(MSG_COMP_START_FAILED, comp->name);
       }
     }
-    usleep(SHUTDOWN_POLLING_INTERVAL * 1000);
-    wait_time += SHUTDOWN_POLLING_INTERVAL;
+  } else if (!prevent_restart) {
+    if (comp->fail_cnt <= comp->restart_intervals.count) {
+      int delay = comp->restart_intervals.data[comp->fail_cnt - 1];
+      INFO(MSG_NEXT_RESTART, comp->name, delay);
+      arm_timer(&zl_context.timers, &comp->restart_timer, get_time_ms(), (uint64_t)delay * 1000);
+    } else {
+      ERROR(MSG_MAX_RETRIES_REACHED, comp->name);
+      abandon_comp_startup(comp);
+    }
   }
-  
-  for (size_t i = 0; i < zl_context.child_count; i++) {
-    zl_comp_t *compkill = &zl_context.children[i];
-    if (compkill->pid > 0) {
-      pid_t pgid = -compkill->pid;
-      DEBUG("Component %s(%d) is not shutting down within %d milliseconds\n", 
-            compkill->name, compkill->pid, SHUTDOWN_GRACEFUL_PERIOD);
-      WARN(MSG_NOT_SIGTERM_STOPPED, compkill->name, compkill->pid);
-      if (kill(pgid, SIGKILL)) {
-        WARN("kill() failed for %s - %s\n", compkill->name, strerror(errno));
-      }
-      rc = -1;
-    }  
+
+  if (zl_context.shutting_down) {
+    stop_ready_components();
+    check_shutdown_complete();
+  }
+}
+
+static void handle_comp_start(zl_comp_t *comp) {
+
+  comp->fail_cnt = 0;
+  cancel_timer(&zl_context.timers, &comp->restart_timer);
+
+  if (comp->pid != -1 && comp->clean_stop) {
+    // still stopping, start it again once it is down
+    comp->restart_requested = true;
+    return;
   }
 
-  if (rc) {
-    WARN(MSG_NOT_ALL_STOPPED);
-  } else {
-    INFO(MSG_COMPS_STOPPED);
+  if (comp->startup_state == ZL_STARTUP_WAITING) {
+    // started by the operator, its prerequisites are not waited for
+    begin_comp_startup(comp);
+    check_startup_complete();
+    return;
   }
-  
-  return 0;
+
+  start_component(comp);
 }
 
 static zl_comp_t *find_comp(const char *name) {
@@ -1143,10 +4487,7 @@ static int handle_start(const char *comp_name) {
     return -1;
   }
 
-  comp->fail_cnt = 0;
-  start_component(comp);
-
-  return 0;
+  return send_event(ZL_EVENT_COMP_START, comp);
 }
 
 static int handle_stop(const char *comp_name) {
@@ -1157,17 +4498,26 @@ static int handle_stop(const char *comp_name) {
     return -1;
   }
 
-  stop_component(comp);
-
-  return 0;
+  return send_event(ZL_EVENT_COMP_STOP, comp);
 }
 
+static void print_event_stats(void);
+static void print_log_stats(void);
+
 static int handle_disp(void) {
 
   INFO(MSG_LAUNCHER_COMPS);
   for (size_t i = 0; i < zl_context.child_count; i++) {
-    INFO(MSG_LAUNCHER_COMP, zl_context.children[i].name, zl_context.children[i].pid);
+    zl_comp_t *comp = &zl_context.children[i];
+    INFO(MSG_LAUNCHER_COMP, comp->name, comp->pid);
+    INFO(MSG_COMP_OUTPUT_STATS, comp->name, atomic_load(&comp->backlog.lag),
+         atomic_load(&comp->backlog.spilled_bytes), atomic_load(&comp->backlog.dropped_lines));
+    if (comp->log_file.enabled) {
+      INFO(MSG_COMP_LOG_FILE_STATS, comp->name, atomic_load(&comp->log_file.dropped_lines));
+    }
   }
+  print_event_stats();
+  print_log_stats();
 
   return 0;
 }
@@ -1244,6 +4594,7 @@ static void *handle_console(void *args) {
 
     } else if (cmd_type == _CC_stop) {
       INFO(MSG_TERM_CMD_RECV);
+      zl_context.console_stopped = true;
       send_event(ZL_EVENT_TERM, NULL);
       break;
     }
@@ -1319,59 +4670,159 @@ static zl_config_t read_config(int argc, char **argv) {
   return result;
 }
 
-static int restart_component(zl_comp_t *comp) {
-  int stop_rc = stop_component(comp);
-  if (stop_rc) {
-    return stop_rc;
-  }
-  return start_component(comp);
+static void print_event_stats(void) {
+  pthread_mutex_lock(&zl_context.event_lock);
+  unsigned long enqueued = zl_context.events_enqueued;
+  unsigned long processed = zl_context.events_processed;
+  unsigned long dropped = zl_context.events_dropped;
+  pthread_mutex_unlock(&zl_context.event_lock);
+  INFO(MSG_EVENT_STATS, enqueued, processed, dropped);
 }
 
-static void monitor_events(void) {
+static void print_writer_stats(zl_log_writer_t *writer) {
+  unsigned long flushes = atomic_load(&writer->flushes);
+  unsigned long flush_time = atomic_load(&writer->flush_time_us);
+  INFO(MSG_LOG_STATS, writer->name,
+       (unsigned long)(atomic_load(&writer->tail) - atomic_load(&writer->head)),
+       atomic_load(&writer->records),
+       atomic_load(&writer->bytes_written),
+       flushes,
+       flushes ? flush_time / flushes : 0,
+       atomic_load(&writer->max_flush_time_us),
+       atomic_load(&writer->full_waits));
+}
 
-  if (pthread_mutex_lock(&zl_context.event_lock) != 0) {
-    DEBUG("monitor_events: pthread_mutex_lock() error - %s\n", strerror(errno));
-    return;
+static void print_log_stats(void) {
+  print_writer_stats(&zl_log_writer);
+  if (zl_file_writer.write_batch) {
+    print_writer_stats(&zl_file_writer);
   }
+}
 
-  while (true) {
+/**
+ * @brief Wait for events, the wait ends early when a timer is due
+ *
+ * @return int 0 on success, -1 on error; the event lock must be held
+ */
+static int wait_for_events(void) {
+
+  while (zl_context.event_count == 0) {
 
-    while (zl_context.event_type == ZL_EVENT_NONE) {
-      if (pthread_cond_wait(&zl_context.event_cv, &zl_context.event_lock) !=0) {
+    int64_t wait_ms = get_timer_wait_ms(&zl_context.timers, get_time_ms());
+    if (wait_ms == 0) {
+      break;
+    }
+
+    if (wait_ms < 0) {
+      if (pthread_cond_wait(&zl_context.event_cv, &zl_context.event_lock) != 0) {
         DEBUG("monitor_events: pthread_cond_wait() error - %s\n",
               strerror(errno));
-        return;
+        return -1;
       }
+      continue;
     }
 
-    DEBUG("event with type %d and data 0x%p has been received\n",
-          zl_context.event_type, zl_context.event_data);
+    // the timers run on the monotonic clock but the condition variable waits
+    // for a wall clock deadline, so keep the waits short and re-check the
+    // timers in case the system clock is set back
+    if (wait_ms > EVENT_WAIT_MAX_MS) {
+      wait_ms = EVENT_WAIT_MAX_MS;
+    }
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    uint64_t deadline_us = (uint64_t)now.tv_sec * 1000000 + now.tv_usec + (uint64_t)wait_ms * 1000;
+    struct timespec deadline = {
+      .tv_sec = deadline_us / 1000000,
+      .tv_nsec = (deadline_us % 1000000) * 1000,
+    };
+    int wait_rc = pthread_cond_timedwait(&zl_context.event_cv, &zl_context.event_lock, &deadline);
+    if (wait_rc == ETIMEDOUT) {
+      continue;
+    } else if (wait_rc != 0) {
+      DEBUG("monitor_events: pthread_cond_timedwait() error - %s\n",
+            strerror(wait_rc));
+      return -1;
+    }
+  }
 
-    if (zl_context.event_type == ZL_EVENT_TERM) {
-      break;
-    } else if (prevent_restart == true) {
-      break;
-    } else if (zl_context.event_type == ZL_EVENT_COMP_RESTART) {
-      zl_comp_t* comp = zl_context.event_data;
-      int restart_rc = restart_component(comp);
-      if (restart_rc) {
-        ERROR(MSG_COMP_RESTART_FAILED, comp->name);
+  return 0;
+}
+
+/**
+ * @brief The supervisor loop: processes the events and runs the timers
+ * until the shutdown is complete. Components are only started and stopped
+ * from here.
+ */
+static void monitor_events(void) {
+
+  zl_event_entry_t batch[EVENT_QUEUE_SIZE];
+
+  while (!zl_context.shutdown_done) {
+
+    if (pthread_mutex_lock(&zl_context.event_lock) != 0) {
+      DEBUG("monitor_events: pthread_mutex_lock() error - %s\n", strerror(errno));
+      return;
+    }
+
+    if (wait_for_events()) {
+      pthread_mutex_unlock(&zl_context.event_lock);
+      return;
+    }
+
+    // take the whole backlog at once so the producers are not held up while
+    // the events are being processed
+    size_t batch_size = zl_context.event_count;
+    for (size_t i = 0; i < batch_size; i++) {
+      batch[i] = zl_context.events[(zl_context.event_head + i) % EVENT_QUEUE_SIZE];
+    }
+    zl_context.event_head = (zl_context.event_head + batch_size) % EVENT_QUEUE_SIZE;
+    zl_context.event_count = 0;
+
+    if (pthread_mutex_unlock(&zl_context.event_lock) != 0) {
+      DEBUG("monitor_events: pthread_mutex_unlock() error - %s\n",
+            strerror(errno));
+      return;
+    }
+
+    run_timers(&zl_context.timers, get_time_ms());
+
+    if (batch_size > 0) {
+      DEBUG("processing a batch of %d events\n", (int)batch_size);
+    }
+
+    for (size_t i = 0; i < batch_size; i++) {
+      zl_event_entry_t *event = &batch[i];
+
+      DEBUG("event with type %d and data 0x%p has been received\n",
+            event->type, event->data);
+
+      if (event->type == ZL_EVENT_TERM) {
+        if (!zl_context.shutting_down) {
+          stop_components();
+        }
+      } else if (event->type == ZL_EVENT_COMP_EXIT) {
+        handle_comp_exit(event->data);
+      } else if (zl_context.shutting_down) {
+        DEBUG("shutting down, event with type %d ignored\n", event->type);
+      } else if (event->type == ZL_EVENT_COMP_START) {
+        handle_comp_start(event->data);
+      } else if (event->type == ZL_EVENT_COMP_STOP) {
+        stop_component(event->data);
+      } else if (event->type == ZL_EVENT_COMP_READY) {
+        handle_comp_ready(event->data);
+      } else {
+        DEBUG("unknown event type %d\n", event->type);
       }
-    } else {
-      DEBUG("unknown event type %d\n", zl_context.event_type);
-      break;
     }
 
-    zl_context.event_type = ZL_EVENT_NONE;
-    zl_context.event_data = NULL;
+    pthread_mutex_lock(&zl_context.event_lock);
+    zl_context.events_processed += batch_size;
+    pthread_mutex_unlock(&zl_context.event_lock);
 
   }
 
-  if (pthread_mutex_unlock(&zl_context.event_lock) != 0) {
-    DEBUG("monitor_events: pthread_mutex_unlock() error - %s\n",
-          strerror(errno));
-    return;
-  }
+  print_event_stats();
+  print_log_stats();
 
 }
 
@@ -1382,198 +4833,620 @@ static int send_event(enum zl_event_t event_type, void *event_data) {
     return -1;
   }
 
-  zl_context.event_type = event_type;
-  zl_context.event_data = event_data;
+  if (zl_context.event_count == EVENT_QUEUE_SIZE) {
+    zl_context.events_dropped++;
+    pthread_mutex_unlock(&zl_context.event_lock);
+    ERROR(MSG_EVENT_DROPPED, event_type);
+    return -1;
+  }
+
+  zl_event_entry_t *event = &zl_context.events[(zl_context.event_head + zl_context.event_count) % EVENT_QUEUE_SIZE];
+  event->type = event_type;
+  event->data = event_data;
+  zl_context.event_count++;
+  zl_context.events_enqueued++;
 
   if (pthread_cond_signal(&zl_context.event_cv) != 0) {
     DEBUG("send_event: pthread_cond_signal() error - %s\n", strerror(errno));
+    pthread_mutex_unlock(&zl_context.event_lock);
     return -1;
   }
 
-  DEBUG("event with type %d and data 0x%p has been sent\n",
-        zl_context.event_type, zl_context.event_data);
-
   if (pthread_mutex_unlock(&zl_context.event_lock) != 0) {
     DEBUG("send_event: pthread_mutex_unlock() error - %s\n", strerror(errno));
     return -1;
   }
 
+  DEBUG("event with type %d and data 0x%p has been sent\n",
+        event_type, event_data);
+
   return 0;
 }
 
 typedef void (*handle_line_callback_t)(void *data, const char *line);
 
-static int run_command(const char *command, handle_line_callback_t handle_line, void *data) {
-  DEBUG("about to run command '%s'\n", command);
-  FILE *fp = popen(command, "r");
-  if (!fp) {
-    ERROR(MSG_CMD_RUN_ERR, command, strerror(errno));
+// The environment of a launcher command, the strings of unescaped values live in one buffer
+typedef struct zl_command_env_t {
+  const char **envp;
+  char *values;
+  char *script; // sh script assigning the values that need expansion, NULL if no value needs it
+} zl_command_env_t;
+
+static bool is_quoted_env(const char *env) {
+  const char *value = strchr(env, '=');
+  size_t len = value ? strlen(value + 1) : 0;
+  return len >= 2 && value[1] == '"' && value[len] == '"';
+}
+
+/**
+ * @brief Get the text of a NAME=value as it goes between double quotes, without the quotes of a
+ * NAME="value"
+ */
+static const char *get_env_text(const char *env, size_t *len) {
+  const char *value = strchr(env, '=') + 1;
+  *len = strlen(value);
+  if (is_quoted_env(env)) {
+    *len -= 2;
+    return value + 1;
+  }
+  return value;
+}
+
+// in double quotes sh only removes a backslash in front of these
+#define SHELL_QUOTED_ESCAPES "$`\"\\"
+
+/**
+ * @brief Check if a value needs parameter or command substitution, which only a shell can do
+ */
+static bool needs_shell_expansion(const char *env) {
+  size_t len;
+  const char *text = get_env_text(env, &len);
+  const char *end = text + len;
+  for (const char *c = text; c < end; c++) {
+    if (c[0] == '\\' && c + 1 < end && strchr(SHELL_QUOTED_ESCAPES, c[1])) {
+      c++;
+    } else if (c[0] == '$' || c[0] == '`') {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Copy a NAME=value as NAME=value with the backslash escapes removed as sh does in double quotes
+ */
+static char *unescape_env(const char *env, char *dest) {
+  size_t len;
+  const char *text = get_env_text(env, &len);
+  const char *end = text + len;
+  size_t name_len = strchr(env, '=') + 1 - env;
+  memcpy(dest, env, name_len);
+  char *out = dest + name_len;
+  for (const char *c = text; c < end; c++) {
+    if (c[0] == '\\' && c + 1 < end && strchr(SHELL_QUOTED_ESCAPES, c[1])) {
+      c++;
+    }
+    *out++ = *c;
+  }
+  *out++ = '\0';
+  return out;
+}
+
+#define COMMAND_EXEC "exec \"$0\" \"$@\""
+
+/**
+ * @brief Build the environment of a launcher command from the shared environment, with each value
+ * in double quotes as a shell would take it, quoted or not in zowe.environments. The values with
+ * $VAR or `cmd` are assigned by a sh script that runs the command, the others are unescaped here.
+ * The launcher variables that are not passed to the components are passed on.
+ */
+static int init_command_env(zl_command_env_t *env) {
+  size_t count = shared_uss_env_count;
+  size_t values_size = 1;
+  size_t script_size = 0;
+  for (size_t i = 0; i < shared_uss_env_count; i++) {
+    if (needs_shell_expansion(shared_uss_env[i])) {
+      script_size += strlen(shared_uss_env[i]) + 4;
+    } else {
+      values_size += strlen(shared_uss_env[i]) + 1;
+    }
+  }
+  for (char **var = environ; *var != 0; var++) {
+    count++;
+  }
+
+  env->envp = malloc((count + 1) * sizeof(char *));
+  env->values = malloc(values_size);
+  env->script = script_size ? malloc(script_size + sizeof(COMMAND_EXEC)) : NULL;
+  if (!shared_uss_env || !env->envp || !env->values || (script_size && !env->script)) {
+    free(env->envp);
+    free(env->values);
+    free(env->script);
     return -1;
   }
-  char *line;
-  char buf[1024] = {0};
-  while((line = fgets(buf, sizeof(buf) - 1, fp)) != NULL) {
-    handle_line(data, line);
-    memset(buf, '\0', sizeof(buf));
+
+  size_t i = 0;
+  char *value = env->values;
+  int pos = 0;
+  for (size_t j = 0; j < shared_uss_env_count; j++) {
+    if (needs_shell_expansion(shared_uss_env[j])) {
+      size_t len;
+      const char *text = get_env_text(shared_uss_env[j], &len);
+      int name_len = strchr(shared_uss_env[j], '=') - shared_uss_env[j];
+      pos += sprintf(env->script + pos, "%.*s=\"%.*s\" ", name_len, shared_uss_env[j], (int)len, text);
+    } else {
+      env->envp[i++] = value;
+      value = unescape_env(shared_uss_env[j], value);
+    }
+  }
+  if (env->script) {
+    strcpy(env->script + pos, COMMAND_EXEC);
+  }
+  for (char **var = environ; *var != 0; var++) {
+    if (!strncmp(*var, "_BPX_SHAREAS=", strlen("_BPX_SHAREAS=")) ||
+        !strncmp(*var, CEE_ENVFILE_PREFIX, strlen(CEE_ENVFILE_PREFIX))) {
+      env->envp[i++] = *var;
+    }
   }
-  if (ferror(fp)) {
-    pclose(fp);
+  env->envp[i] = NULL;
+  return 0;
+}
+
+static void free_command_env(zl_command_env_t *env) {
+  free(env->envp);
+  free(env->values);
+  free(env->script);
+}
+
+/**
+ * @brief Pass the output of a launcher command line by line to the callback and wait for its end
+ *
+ * @param fd The read end of the pipe with the stdout and stderr of the command, closed
+ * @param exit_code The exit code, 128 + the signal if the command was killed, -1 if it couldn't be waited for
+ * @return int 0 if the whole output was read
+ */
+static int wait_command(const char *command, int fd, pid_t pid, handle_line_callback_t handle_line, void *data,
+                        int *exit_code) {
+  int rc = 0;
+  FILE *fp = fdopen(fd, "r");
+  if (fp) {
+    char *line;
+    char buf[1024] = {0};
+    while((line = fgets(buf, sizeof(buf) - 1, fp)) != NULL) {
+      handle_line(data, line);
+      memset(buf, '\0', sizeof(buf));
+    }
+    if (ferror(fp)) {
+      ERROR(MSG_CMD_OUT_ERR, command, strerror(errno));
+      rc = -1;
+    }
+    fclose(fp);
+  } else {
     ERROR(MSG_CMD_OUT_ERR, command, strerror(errno));
+    close(fd);
+    rc = -1;
+  }
+
+  int status = 0;
+  pid_t waited;
+  while ((waited = waitpid(pid, &status, 0)) == -1 && errno == EINTR);
+  if (waited == -1) {
+    ERROR(MSG_CMD_RUN_ERR, command, strerror(errno));
+    *exit_code = -1;
+    return -1;
+  }
+
+  *exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+  return rc;
+}
+
+/**
+ * @brief Run a launcher command, through sh only if the environment has values to expand. Its
+ * stdout and stderr are passed line by line to the callback. Must be called before the reactor
+ * reaps the children of the launcher.
+ *
+ * @param argv The program and its arguments
+ * @return int 0 if the command ended with code 0
+ */
+static int run_command(const char *argv[], handle_line_callback_t handle_line, void *data) {
+  char command[PATH_MAX * 2] = {0};
+  int pos = 0;
+  int argc = 0;
+  for (; argv[argc] && pos < (int)sizeof(command); argc++) {
+    pos += snprintf(command + pos, sizeof(command) - pos, "%s%s", argc ? " " : "", argv[argc]);
+  }
+  for (; argv[argc]; argc++);
+  DEBUG("about to run command '%s'\n", command);
+
+  zl_command_env_t env;
+  if (init_command_env(&env)) {
+    ERROR(MSG_CMD_RUN_ERR, command, strerror(ENOMEM));
     return -1;
   }
-  int rc = pclose(fp);
-  if (rc == -1) {
+
+  // sh -c 'NAME="$VAR" exec "$0" "$@"' program args...
+  const char **shell_argv = NULL;
+  if (env.script) {
+    DEBUG("command '%s' is run by sh to expand the environment\n", command);
+    shell_argv = malloc((argc + 4) * sizeof(char *));
+    if (!shell_argv) {
+      ERROR(MSG_CMD_RUN_ERR, command, strerror(ENOMEM));
+      free_command_env(&env);
+      return -1;
+    }
+    shell_argv[0] = "/bin/sh";
+    shell_argv[1] = "-c";
+    shell_argv[2] = env.script;
+    memcpy(shell_argv + 3, argv, (argc + 1) * sizeof(char *));
+  }
+
+  int output[2];
+  if (pipe(output)) {
     ERROR(MSG_CMD_RUN_ERR, command, strerror(errno));
-  } else if (rc > 0) {
-    WARN(MSG_CMD_RCP_WARN, command, rc);
+    free(shell_argv);
+    free_command_env(&env);
+    return -1;
+  }
+
+  struct inheritance inherit = {0};
+  int fd_map[3] = {STDIN_FILENO, output[1], output[1]};
+  uint64_t begin = get_time_ms();
+  pid_t pid = shell_argv ? spawn(shell_argv[0], 3, fd_map, &inherit, shell_argv, env.envp)
+                         : spawn(argv[0], 3, fd_map, &inherit, argv, env.envp);
+  int spawn_errno = errno;
+  close(output[1]);
+  free(shell_argv);
+  free_command_env(&env);
+  if (pid == -1) {
+    close(output[0]);
+    ERROR(MSG_CMD_RUN_ERR, command, strerror(spawn_errno));
+    return -1;
+  }
+
+  int exit_code = -1;
+  int rc = wait_command(command, output[0], pid, handle_line, data, &exit_code);
+  if (exit_code == -1) {
+    return -1;
+  }
+
+  INFO(MSG_CMD_ENDED, command, exit_code, (unsigned long)(get_time_ms() - begin));
+  if (exit_code != 0) {
+    WARN(MSG_CMD_RCP_WARN, command, exit_code);
+    return -1;
+  }
+  if (rc == 0) {
+    DEBUG("command '%s' ran successfully\n", command);
+  }
+  return rc;
+}
+
+static int check_if_yaml_exists(const char *yaml, const char *name, struct stat *s) {
+  if (stat(yaml, s) != 0) {
+    DEBUG("failed to get properties for file %s='%s' - %s\n", name, yaml, strerror(errno));
     return -1;
   }
-  DEBUG("command '%s' ran successfully\n", command);
   return 0;
 }
 
-static void handle_get_component_line(void *data, const char *line) {
-  char *comp_list = data;
-  snprintf(comp_list, COMP_LIST_SIZE, "%s", line);
-  int len = strlen(comp_list);
-  for (int i = len - 1; i >= 0; i--) {
-    if (comp_list[i] != ' ' && comp_list[i] != '\n' && comp_list[i] != ',') {
+static void get_yaml_pair_key(yaml_document_t *document, yaml_node_pair_t *pair, char *buf, size_t buf_size) {
+  yaml_node_t *node = yaml_document_get_node(document, pair->key);
+  if (node) {
+    snprintf(buf, buf_size, "%.*s", (int)node->data.scalar.length, (const char *)node->data.scalar.value);
+#ifdef __MVS__
+    __atoe(buf);
+#endif
+  } else {
+    snprintf(buf, buf_size, "");
+    DEBUG ("key node not found\n");
+  }
+}
+
+static yaml_node_t *get_child_node(yaml_document_t *doc, yaml_node_t *node, const char *name) {
+  char key[ZL_YAML_KEY_LEN + 1];
+  yaml_node_t *value_node = NULL;
+  for (yaml_node_pair_t *pair = node->data.mapping.pairs.start; pair != node->data.mapping.pairs.top; pair++) {
+    get_yaml_pair_key(doc, pair, key, sizeof(key));
+    if (0 == strcmp(key, name)) {
+      value_node = yaml_document_get_node(doc, pair->value);
+      break;
+    }
+  }
+  return value_node;
+}
+
+static void get_yaml_scalar(yaml_document_t *doc, yaml_node_t *node, char *buf, size_t buf_size) {
+  char *value = (char *)node->data.scalar.value;
+  snprintf(buf, buf_size, "%s", value);
+#ifdef __MVS__
+  __atoe(buf);
+#endif
+}
+
+static yaml_node_t *get_node_by_path(yaml_document_t *doc, yaml_node_t *node, const char **path, size_t path_len) {
+  for (size_t i = 0; i < path_len; i++) {
+    node = get_child_node(doc, node, path[i]);
+    if (!node) {
+      break;
+    }
+  }
+  return node;
+}
+
+static int get_string_by_yaml_path(yaml_document_t *doc, yaml_node_t *root, const char **path, size_t path_len, char *buf, int buf_size) {
+  yaml_node_t *node = get_node_by_path(doc, root, path, path_len);
+  if (node && node->type == YAML_SCALAR_NODE) {
+    get_yaml_scalar(doc, node, buf, buf_size);
+    return 0;
+  }
+  return -1;
+}
+
+typedef struct zl_manifest_probe_t {
+  const char *name;
+  char path[PATH_MAX];
+  bool found;
+  bool start; // the manifest has commands.start
+  // identity of the manifest file
+  unsigned long long inode;
+  unsigned long long size;
+  long long mtime;
+  bool cached; // answered from the manifest cache
+  uint64_t stat_time; // us
+  uint64_t parse_time; // us
+} zl_manifest_probe_t;
+
+// manifest cache entries as loaded from <workspaceDirectory>/.launcher/manifest.cache
+typedef struct zl_manifest_cache_t {
+  zl_manifest_probe_t *entries;
+  char *names;
+  size_t count;
+} zl_manifest_cache_t;
+
+// manifests of the enabled components, probed by a pool of threads that take
+// the next one until none is left
+typedef struct zl_manifest_scan_t {
+  zl_manifest_probe_t *probes;
+  size_t count;
+  atomic_size_t next;
+  const char *runtime_dir;
+  const char *extension_dir;
+  const zl_manifest_cache_t *cache;
+} zl_manifest_scan_t;
+
+static void get_manifest_cache_path(char *path, size_t size) {
+  snprintf(path, size, "%s/%s/%s", zl_context.workspace_dir, LAUNCHER_DIR, MANIFEST_CACHE_FILE);
+}
+
+static void free_manifest_cache(zl_manifest_cache_t *cache) {
+  free(cache->entries);
+  free(cache->names);
+  memset(cache, 0, sizeof(*cache));
+}
+
+/**
+ * @brief Load the manifest cache. A cache that is missing, corrupt or written by
+ * another launcher version is left empty, it is rebuilt after the scan.
+ */
+static void load_manifest_cache(zl_manifest_cache_t *cache, size_t max_count) {
+  char path[PATH_MAX];
+  get_manifest_cache_path(path, sizeof(path));
+  memset(cache, 0, sizeof(*cache));
+
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    DEBUG("manifest cache '%s' not read - %s\n", path, strerror(errno));
+    return;
+  }
+
+  char header[128];
+  char line[PATH_MAX + 256];
+  snprintf(header, sizeof(header), "%s %d %s\n", MANIFEST_CACHE_HEADER, MANIFEST_CACHE_FORMAT, LAUNCHER_VERSION);
+  if (!fgets(line, sizeof(line), file) || strcmp(line, header)) {
+    DEBUG("manifest cache '%s' is from another launcher version\n", path);
+    fclose(file);
+    return;
+  }
+
+  cache->entries = calloc(max_count ? max_count : 1, sizeof(zl_manifest_probe_t));
+  cache->names = calloc(max_count ? max_count : 1, ZL_YAML_KEY_LEN + 1);
+  if (!cache->entries || !cache->names) {
+    free_manifest_cache(cache);
+    fclose(file);
+    return;
+  }
+
+  uint32_t checksum = FNV_OFFSET_BASIS;
+  bool complete = false;
+  while (fgets(line, sizeof(line), file)) {
+    unsigned long count = 0;
+    unsigned long expected = 0;
+    if (sscanf(line, "end %lu %lx", &count, &expected) == 2) {
+      complete = count == cache->count && expected == checksum && fgetc(file) == EOF;
       break;
     }
-    comp_list[i] = '\0';
+    if (cache->count == max_count) {
+      break;
+    }
+    zl_manifest_probe_t *entry = &cache->entries[cache->count];
+    char *name = cache->names + cache->count * (ZL_YAML_KEY_LEN + 1);
+    int start = 0;
+    int name_offset = 0;
+    size_t len = strlen(line);
+    if (len == 0 || line[len - 1] != '\n' ||
+        sscanf(line, "%d %llu %llu %lld %n", &start, &entry->inode, &entry->size, &entry->mtime, &name_offset) != 4 ||
+        !name_offset) {
+      break;
+    }
+    size_t name_len = strcspn(line + name_offset, " ");
+    if (name_len == 0 || name_len > ZL_YAML_KEY_LEN || line[name_offset + name_len] != ' ') {
+      break;
+    }
+    checksum = hash_string(checksum, line);
+    line[len - 1] = '\0';
+    memcpy(name, line + name_offset, name_len);
+    snprintf(entry->path, sizeof(entry->path), "%s", line + name_offset + name_len + 1);
+    entry->name = name;
+    entry->found = true;
+    entry->start = start;
+    cache->count++;
+  }
+  fclose(file);
+
+  if (!complete) {
+    DEBUG("manifest cache '%s' is corrupt, it will be rebuilt\n", path);
+    free_manifest_cache(cache);
   }
 }
 
-static char* get_launch_components_cmd(char* sharedenv) {
-  const char basecmd[] = "%s ZWE_CLI_PARAMETER_CONFIG=\"%s\" %s/bin/utils/configmgr -script %s/bin/commands/internal/get-launch-components/cli.js 2>&1";
-  int size = (strlen(zl_context.root_dir) * 2) + strlen(zl_context.config_path) + strlen(sharedenv) + sizeof(basecmd) + 1;
-  char *command = malloc(size);
+/**
+ * @brief Write the manifest cache, to a temporary file first so that a launcher that
+ * fails while writing doesn't leave a truncated cache
+ */
+static void save_manifest_cache(const zl_manifest_scan_t *scan) {
+  char path[PATH_MAX];
+  char tmp_path[PATH_MAX + 16];
+  snprintf(path, sizeof(path), "%s/%s", zl_context.workspace_dir, LAUNCHER_DIR);
+  if (mkdir_all(path, 0770) != 0) {
+    DEBUG("manifest cache not saved, failed to create '%s' - %s\n", path, strerror(errno));
+    return;
+  }
+  get_manifest_cache_path(path, sizeof(path));
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+
+  FILE *file = fopen(tmp_path, "w");
+  if (!file) {
+    DEBUG("manifest cache '%s' not saved - %s\n", tmp_path, strerror(errno));
+    return;
+  }
+
+  char line[PATH_MAX + 256];
+  uint32_t checksum = FNV_OFFSET_BASIS;
+  unsigned long count = 0;
+  fprintf(file, "%s %d %s\n", MANIFEST_CACHE_HEADER, MANIFEST_CACHE_FORMAT, LAUNCHER_VERSION);
+  for (size_t i = 0; i < scan->count; i++) {
+    const zl_manifest_probe_t *probe = &scan->probes[i];
+    // only a found manifest has an identity, names and paths must fit on one line
+    if (!probe->found || strlen(probe->name) > ZL_YAML_KEY_LEN || strpbrk(probe->name, " \t\n") || strchr(probe->path, '\n')) {
+      continue;
+    }
+    snprintf(line, sizeof(line), "%d %llu %llu %lld %s %s\n", probe->start ? 1 : 0,
+             probe->inode, probe->size, probe->mtime, probe->name, probe->path);
+    checksum = hash_string(checksum, line);
+    fputs(line, file);
+    count++;
+  }
+  fprintf(file, "end %lu %lx\n", count, (unsigned long)checksum);
+
+  if (fclose(file) != 0 || rename(tmp_path, path) != 0) {
+    DEBUG("manifest cache '%s' not saved - %s\n", path, strerror(errno));
+    unlink(tmp_path);
+  }
+}
 
-  snprintf(command, size, basecmd,
-           sharedenv, zl_context.config_path, zl_context.root_dir, zl_context.root_dir);
-  return command;
+static const zl_manifest_probe_t *find_manifest_cache_entry(const zl_manifest_cache_t *cache, const char *name) {
+  for (size_t i = 0; i < cache->count; i++) {
+    if (!strcmp(cache->entries[i].name, name)) {
+      return &cache->entries[i];
+    }
+  }
+  return NULL;
 }
 
 /**
- * @brief Get the sharedenv. The function contemplates enclosing in quotes the values of the variables.
- * 
- * @return char* string representation of the shared_uss_env variable, e.g. VAR1="sample" VAR2=12345
+ * @brief Find the manifest of a component, in <runtimeDirectory>/components/<name> or else
+ * in <extensionDirectory>/<name>, and check it for commands.start. The manifest is not
+ * parsed if the cache has an entry for the same file with the same inode, size and mtime.
  */
-static char* get_sharedenv(void) {
-  char *output = NULL;
-  char *aux = NULL;
+static void probe_manifest(const zl_manifest_scan_t *scan, zl_manifest_probe_t *probe) {
+  const char *start_path[] = {"commands", "start"};
+  uint64_t begin = get_time_us();
+  struct stat s;
 
-  int required = 0;
-  for (char **env = shared_uss_env + 1; *env != 0; env++) { // First element is NULL, reserved to _BPX_SHAREAS
-    char *thisEnv = *env;
-    required += (strlen(thisEnv) + 3); // space + quotes
+  snprintf(probe->path, sizeof(probe->path), "%s/components/%s/manifest.yaml", scan->runtime_dir, probe->name);
+  bool yamlExists = !check_if_yaml_exists(probe->path, "MANIFEST.YAML", &s);
+  if (!yamlExists) {
+    snprintf(probe->path, sizeof(probe->path), "%s/%s/manifest.yaml", scan->extension_dir, probe->name);
+    yamlExists = !check_if_yaml_exists(probe->path, "MANIFEST.YAML", &s);
   }
-
-  required++;
-  output = malloc(required);
-  aux = malloc(required);
-  for (char **env = shared_uss_env + 1; *env != 0; env++) { // First element is NULL, reserved to _BPX_SHAREAS
-    char *thisEnv = *env;
-    strcat(aux, thisEnv);
-    char *envName = strtok(aux, "=");
-    if (envName) {
-      strcat(output, envName);
-      char *envValue = &thisEnv[strlen(envName) + 1];
-      if (*envValue == '"') { // Env value is already enclosed in quotes
-        strcat(output, "=");
-        strcat(output, envValue);
-        trimRight(output, strlen(output));
-        strcat(output, " ");
-      } else {
-        strcat(output, "=\"");
-        strcat(output, envValue);
-        trimRight(output, strlen(output));
-        strcat(output, "\" ");
-      }
-    }
-    aux[0] = 0;
+  uint64_t found = get_time_us();
+  probe->stat_time = found - begin;
+  if (!yamlExists) {
+    return;
+  }
+  probe->found = true;
+  probe->inode = s.st_ino;
+  probe->size = s.st_size;
+  probe->mtime = s.st_mtime;
+
+  const zl_manifest_probe_t *entry = find_manifest_cache_entry(scan->cache, probe->name);
+  if (entry && entry->inode == probe->inode && entry->size == probe->size &&
+      entry->mtime == probe->mtime && !strcmp(entry->path, probe->path)) {
+    probe->start = entry->start;
+    probe->cached = true;
+    return;
   }
-  trimRight(output, strlen(output));
-  free(aux);
-  return output;
-}
 
-static int check_if_yaml_exists(const char *yaml, const char *name) {
-  struct stat s;
-  if (stat(yaml, &s) != 0) {
-    DEBUG("failed to get properties for file %s='%s' - %s\n", name, yaml, strerror(errno));
-    return -1;
+  char errorBuffer[YAML_ERROR_MAX];
+  char item[128] = {0};
+  bool wasMissing = false;
+  yaml_document_t *document = readYAML2(probe->path, errorBuffer, YAML_ERROR_MAX, &wasMissing);
+  yaml_node_t *root = document ? yaml_document_get_root_node(document) : NULL;
+  if (root) {
+    probe->start = !get_string_by_yaml_path(document, root, start_path, sizeof(start_path)/sizeof(start_path[0]), item, sizeof(item));
   }
-  return 0;
+  probe->parse_time = get_time_us() - found;
 }
 
-static void get_yaml_pair_key(yaml_document_t *document, yaml_node_pair_t *pair, char *buf, size_t buf_size) {
-  yaml_node_t *node = yaml_document_get_node(document, pair->key);
-  if (node) {
-    snprintf(buf, buf_size, "%.*s", (int)node->data.scalar.length, (const char *)node->data.scalar.value);
-#ifdef __MVS__
-    __atoe(buf);
-#endif
-  } else {
-    snprintf(buf, buf_size, "");
-    DEBUG ("key node not found\n");
+static void *handle_manifest_scan(void *args) {
+  zl_manifest_scan_t *scan = args;
+  size_t i;
+  while ((i = atomic_fetch_add(&scan->next, 1)) < scan->count) {
+    probe_manifest(scan, &scan->probes[i]);
   }
+  return NULL;
 }
 
-static yaml_node_t *get_child_node(yaml_document_t *doc, yaml_node_t *node, const char *name) {
-  char key[ZL_YAML_KEY_LEN + 1];
-  yaml_node_t *value_node = NULL;
-  for (yaml_node_pair_t *pair = node->data.mapping.pairs.start; pair != node->data.mapping.pairs.top; pair++) {
-    get_yaml_pair_key(doc, pair, key, sizeof(key));
-    if (0 == strcmp(key, name)) {
-      value_node = yaml_document_get_node(doc, pair->value);
+/**
+ * @brief Probe all the manifests with up to thread_count threads, the calling thread included
+ */
+static void scan_manifests(zl_manifest_scan_t *scan, int thread_count) {
+  pthread_t threads[MANIFEST_SCAN_THREADS_MAX];
+  int started = 0;
+
+  if ((size_t)thread_count > scan->count) {
+    thread_count = scan->count;
+  }
+  for (int i = 1; i < thread_count; i++) {
+    if (pthread_create(&threads[started], NULL, handle_manifest_scan, scan) != 0) {
+      DEBUG("pthread_create() for manifest scan - %s\n", strerror(errno));
       break;
     }
+    started++;
   }
-  return value_node;
-}
 
-static void get_yaml_scalar(yaml_document_t *doc, yaml_node_t *node, char *buf, size_t buf_size) {
-  char *value = (char *)node->data.scalar.value;
-  snprintf(buf, buf_size, "%s", value);
-#ifdef __MVS__
-  __atoe(buf);
-#endif
-}
+  handle_manifest_scan(scan);
 
-static yaml_node_t *get_node_by_path(yaml_document_t *doc, yaml_node_t *node, const char **path, size_t path_len) {
-  for (size_t i = 0; i < path_len; i++) {
-    node = get_child_node(doc, node, path[i]);
-    if (!node) {
-      break;
-    }
+  for (int i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
   }
-  return node;
 }
 
-static int get_string_by_yaml_path(yaml_document_t *doc, yaml_node_t *root, const char **path, size_t path_len, char *buf, int buf_size) {
-  yaml_node_t *node = get_node_by_path(doc, root, path, path_len);
-  if (node && node->type == YAML_SCALAR_NODE) {
-    get_yaml_scalar(doc, node, buf, buf_size);
-    return 0;
+static int get_manifest_scan_threads(void) {
+  int threads = MANIFEST_SCAN_THREADS_DEFAULT;
+  int getStatus = get_json_int(get_config_value("zowe.launcher.manifestScanThreads"), &threads);
+  if (getStatus != ZCFG_SUCCESS || threads <= 0) {
+    return MANIFEST_SCAN_THREADS_DEFAULT;
   }
-  return -1;
+  return threads > MANIFEST_SCAN_THREADS_MAX ? MANIFEST_SCAN_THREADS_MAX : threads;
 }
 
 static int get_component_list(char *buf, size_t buf_size,ConfigManager *configmgr) {
   char comp_list[COMP_LIST_SIZE] = {0};
   Json *result = NULL;
-  char manifestPath[PATH_MAX]={0};
   char *runtimeDirectory=NULL;
   char *extensionDirectory=NULL;
-  char item[128] = {0};
-  const char *start_path[] = {"commands", "start"};
   int len = 0;
-  char errorBuffer[YAML_ERROR_MAX];
-  bool yamlExists;
-  bool startScript;
   bool enabled;
-  bool wasMissing = false;
 
   bool checkHaSection = false;
 
@@ -1619,62 +5492,86 @@ static int get_component_list(char *buf, size_t buf_size,ConfigManager *configmg
       return -1;
     }
 
-    
+    size_t prop_count = 0;
+    for (JsonProperty *p = prop; p != NULL; p = p->next) {
+      prop_count++;
+    }
+    zl_manifest_scan_t scan = {
+      .probes = calloc(prop_count ? prop_count : 1, sizeof(zl_manifest_probe_t)),
+      .runtime_dir = runtimeDirectory,
+      .extension_dir = extensionDirectory,
+    };
+    if (!scan.probes) {
+      ERROR(MSG_COMP_LIST_ERR);
+      return -1;
+    }
 
+    // the configuration is only read here, the manifests are probed in parallel
     while (prop!=NULL) {
       enabled = false;
       // check if component is enabled
       if (checkHaSection) {
-        getStatus = cfgGetBooleanC(configmgr, ZOWE_CONFIG_NAME, &enabled, 5, "haInstances", zl_context.ha_instance_id, "components", prop->key, "enabled");
+        getStatus = get_json_bool(get_config_value("haInstances.%s.components.%s.enabled", zl_context.ha_instance_id, prop->key), &enabled);
         if (getStatus) {
-          getStatus = cfgGetBooleanC(configmgr, ZOWE_CONFIG_NAME, &enabled,3, "components", prop->key, "enabled");
+          getStatus = get_json_bool(get_config_value("components.%s.enabled", prop->key), &enabled);
         }
       } else {
-        getStatus = cfgGetBooleanC(configmgr, ZOWE_CONFIG_NAME, &enabled,3, "components", prop->key, "enabled");
+        getStatus = get_json_bool(get_config_value("components.%s.enabled", prop->key), &enabled);
       }
       
       if (getStatus) { // failed to get enabled value of the component
         DEBUG("failed to get enabled value of the component %s\n", prop->key);
-        prop = prop->next;
-        continue;
+      } else if (enabled) {
+        scan.probes[scan.count++].name = prop->key;
       }
+      prop = prop->next;
+    }
 
-      yamlExists = true; //unused if not enabled. otherwise set to false if not found.
-      if (enabled) {
-        snprintf(manifestPath, PATH_MAX, "%s/components/%s/manifest.yaml", runtimeDirectory, prop->key);
-        DEBUG("manifest path for component %s is %s\n", prop->key, manifestPath);
-  
-        // check if manifest.yaml is in <runtimeDirectory>/components/<component-name>/manifest.yaml
-        if (check_if_yaml_exists(manifestPath, "MANIFEST.YAML")) {
-          yamlExists = false;
-          // if not check <extensionDirectory>/<component-name>/manifest.yaml
-          snprintf(manifestPath, PATH_MAX, "%s/%s/manifest.yaml", extensionDirectory, prop->key);
-          DEBUG("manifest path for component %s is %s\n", prop->key, manifestPath);
-          if(!check_if_yaml_exists(manifestPath, "MANIFEST.YAML")) {
-             yamlExists = true;
-          }
-        }
-      }
+    zl_manifest_cache_t cache;
+    load_manifest_cache(&cache, prop_count);
+    scan.cache = &cache;
 
-      // read the yaml and check for item 'commands.start', if present then add enabled component to component list
-      startScript = false;
-      if(enabled && yamlExists) {
-        yaml_document_t *document = readYAML2(manifestPath, errorBuffer, YAML_ERROR_MAX, &wasMissing);
-        yaml_node_t *root =  yaml_document_get_root_node(document);
-        if (root) {
-            getStatus = get_string_by_yaml_path(document, root, start_path, sizeof(start_path)/sizeof(start_path[0]), item, sizeof(item));
-            memset(item, 0, sizeof(item));
-            if(!getStatus)
-              startScript = true;
-        }
-        if (startScript) {
-          strncpy(comp_list + len, prop->key, strlen(prop->key));
-          strncpy(comp_list + len + strlen(prop->key), ",", 1);
-          len += (strlen(prop->key)+1);
-        }
+    int thread_count = get_manifest_scan_threads();
+    uint64_t scan_begin = get_time_us();
+    scan_manifests(&scan, thread_count);
+    DEBUG("%d manifests scanned in %lu us, threads = %d\n", (int)scan.count,
+          (unsigned long)(get_time_us() - scan_begin), thread_count);
+
+    // the cache is rewritten when anything has changed, it then holds the enabled components only
+    int hits = 0;
+    for (size_t i = 0; i < scan.count; i++) {
+      hits += scan.probes[i].cached;
+    }
+    INFO(MSG_MANIFEST_CACHE, hits, (int)scan.count - hits);
+    if (hits != (int)scan.count || cache.count != scan.count) {
+      save_manifest_cache(&scan);
+    }
+    free_manifest_cache(&cache);
+
+    // merged in the order of the components in the configuration
+    zl_context.manifest_hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < scan.count; i++) {
+      zl_manifest_probe_t *probe = &scan.probes[i];
+      char identity[PATH_MAX + 256];
+      snprintf(identity, sizeof(identity), "%d %d %llu %llu %lld %s %s\n", probe->found ? 1 : 0, probe->start ? 1 : 0,
+               probe->inode, probe->size, probe->mtime, probe->name, probe->path);
+      zl_context.manifest_hash = hash_string(zl_context.manifest_hash, identity);
+      DEBUG("manifest path for component %s is %s, stat = %lu us, parse = %lu us, cached = %s, start = %s\n",
+            probe->name, probe->path, (unsigned long)probe->stat_time, (unsigned long)probe->parse_time,
+            probe->cached ? "yes" : "no", probe->start ? "yes" : "no");
+      if (!probe->start) {
+        continue;
       }
-      prop = prop->next;
+      size_t name_len = strlen(probe->name);
+      if (len + name_len + 1 >= sizeof(comp_list)) {
+        ERROR(MSG_MAX_COMP_REACHED);
+        break;
+      }
+      memcpy(comp_list + len, probe->name, name_len);
+      comp_list[len + name_len] = ',';
+      len += (name_len+1);
     }
+    free(scan.probes);
     if (len)
       comp_list[len-1] = '\0';
   }
@@ -1725,6 +5622,310 @@ static int process_root_dir(ConfigManager *configmgr) {
   return check_root_dir();
 }
 
+typedef struct zl_json_buffer_t {
+  char *data;
+  size_t len;
+  size_t capacity;
+  bool failed;
+} zl_json_buffer_t;
+
+static void append_json_text(zl_json_buffer_t *buf, const char *text, size_t len) {
+  if (buf->failed) {
+    return;
+  }
+  if (buf->len + len > buf->capacity) {
+    size_t capacity = buf->capacity ? buf->capacity : 64 * 1024;
+    while (capacity < buf->len + len) {
+      capacity *= 2;
+    }
+    char *data = realloc(buf->data, capacity);
+    if (!data) {
+      buf->failed = true;
+      return;
+    }
+    buf->data = data;
+    buf->capacity = capacity;
+  }
+  memcpy(buf->data + buf->len, text, len);
+  buf->len += len;
+}
+
+static void append_json_string(zl_json_buffer_t *buf, const char *str) {
+  append_json_text(buf, "\"", 1);
+  const char *start = str;
+  for (const char *c = str; *c; c++) {
+    char escape[8] = {0};
+    switch (*c) {
+    case '"':  strcpy(escape, "\\\""); break;
+    case '\\': strcpy(escape, "\\\\"); break;
+    case '\n': strcpy(escape, "\\n"); break;
+    case '\r': strcpy(escape, "\\r"); break;
+    case '\t': strcpy(escape, "\\t"); break;
+    default:
+      if (iscntrl((unsigned char)*c)) {
+        char code = *c;
+#ifdef __MVS__
+        __etoa_l(&code, 1);
+#endif
+        snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char)code);
+      }
+      break;
+    }
+    if (escape[0]) {
+      append_json_text(buf, start, c - start);
+      append_json_text(buf, escape, strlen(escape));
+      start = c + 1;
+    }
+  }
+  append_json_text(buf, start, strlen(start));
+  append_json_text(buf, "\"", 1);
+}
+
+static void append_json_node(zl_json_buffer_t *buf, Json *node) {
+  char number[64];
+  if (jsonIsObject(node)) {
+    append_json_text(buf, "{", 1);
+    for (JsonProperty *prop = jsonAsObject(node)->firstProperty; prop != NULL; prop = prop->next) {
+      append_json_string(buf, prop->key);
+      append_json_text(buf, ":", 1);
+      append_json_node(buf, prop->value);
+      if (prop->next) {
+        append_json_text(buf, ",", 1);
+      }
+    }
+    append_json_text(buf, "}", 1);
+  } else if (jsonIsArray(node)) {
+    JsonArray *array = jsonAsArray(node);
+    append_json_text(buf, "[", 1);
+    for (int i = 0; i < array->count; i++) {
+      if (i > 0) {
+        append_json_text(buf, ",", 1);
+      }
+      append_json_node(buf, array->elements[i]);
+    }
+    append_json_text(buf, "]", 1);
+  } else if (jsonIsString(node)) {
+    append_json_string(buf, jsonAsString(node));
+  } else if (jsonIsBoolean(node)) {
+    append_json_text(buf, jsonAsBoolean(node) ? "true" : "false", jsonAsBoolean(node) ? 4 : 5);
+  } else if (jsonIsInt64(node)) {
+    append_json_text(buf, number, snprintf(number, sizeof(number), "%lld", (long long)jsonAsInt64(node)));
+  } else if (jsonIsDouble(node)) {
+    append_json_text(buf, number, snprintf(number, sizeof(number), "%.17g", jsonAsDouble(node)));
+  } else if (jsonIsNumber(node)) {
+    append_json_text(buf, number, snprintf(number, sizeof(number), "%d", jsonAsNumber(node)));
+  } else {
+    append_json_text(buf, "null", 4);
+  }
+}
+
+/**
+ * @brief Write the merged and validated configuration to <workspaceDirectory>/.launcher/zowe-config.json
+ * as compact JSON in ISO8859-1, with its FNV-1a hash, if zowe.launcher.configSnapshot is true. The
+ * components get the path and the hash in ZWE_PRIVATE_CONFIG_SNAPSHOT and
+ * ZWE_PRIVATE_CONFIG_SNAPSHOT_HASH, so that a component start can load it instead of parsing and
+ * validating the configuration layers again. The zwe start script doesn't read it yet, so it's off
+ * by default. The snapshot holds everything zowe.yaml does, secrets included, it's only readable
+ * by the launcher user and removed when the option is off.
+ */
+static void write_config_snapshot(ConfigManager *configmgr) {
+  char path[PATH_MAX];
+  char tmp_path[PATH_MAX + 16];
+  snprintf(path, sizeof(path), "%s/%s/%s", zl_context.workspace_dir, LAUNCHER_DIR, CONFIG_SNAPSHOT_FILE);
+
+  bool enabled = false;
+  get_json_bool(get_config_value("zowe.launcher.configSnapshot"), &enabled);
+  if (!enabled) {
+    if (unlink(path) == 0) {
+      DEBUG("configuration snapshot '%s' removed\n", path);
+    }
+    return;
+  }
+
+  Json *config = cfgGetConfigData(configmgr, ZOWE_CONFIG_NAME);
+  if (!config) {
+    WARN(MSG_CFG_SNAPSHOT_ERR, "no configuration data");
+    return;
+  }
+  zl_json_buffer_t buf = {0};
+  append_json_node(&buf, config);
+  append_json_text(&buf, "\n", 1);
+  if (buf.failed) {
+    WARN(MSG_CFG_SNAPSHOT_ERR, strerror(ENOMEM));
+    free(buf.data);
+    return;
+  }
+#ifdef __MVS__
+  __etoa_l(buf.data, buf.len);
+#endif
+  uint32_t hash = hash_bytes(FNV_OFFSET_BASIS, buf.data, buf.len);
+
+  snprintf(tmp_path, sizeof(tmp_path), "%s/%s", zl_context.workspace_dir, LAUNCHER_DIR);
+  if (mkdir_all(tmp_path, 0770) != 0) {
+    WARN(MSG_CFG_SNAPSHOT_ERR, strerror(errno));
+    free(buf.data);
+    return;
+  }
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+
+  int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd == -1) {
+    WARN(MSG_CFG_SNAPSHOT_ERR, strerror(errno));
+    free(buf.data);
+    return;
+  }
+#ifdef __MVS__
+  struct file_tag tag = {.ft_ccsid = 819, .ft_txtflag = 1};
+  fcntl(fd, F_SETTAG, &tag);
+#endif
+  size_t written = 0;
+  while (written < buf.len) {
+    ssize_t rc = write(fd, buf.data + written, buf.len - written);
+    if (rc == -1 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      break;
+    }
+    written += rc;
+  }
+  free(buf.data);
+  if (close(fd) != 0 || written < buf.len || rename(tmp_path, path) != 0) {
+    WARN(MSG_CFG_SNAPSHOT_ERR, strerror(errno));
+    unlink(tmp_path);
+    return;
+  }
+
+  snprintf(zl_context.config_snapshot_env, sizeof(zl_context.config_snapshot_env), "%s=%s", CONFIG_SNAPSHOT_ENV, path);
+  snprintf(zl_context.config_snapshot_hash_env, sizeof(zl_context.config_snapshot_hash_env), "%s=%08lx",
+           CONFIG_SNAPSHOT_HASH_ENV, (unsigned long)hash);
+  INFO(MSG_CFG_SNAPSHOT, path, (unsigned long)hash);
+}
+
+/**
+ * @brief Get the path of a launcher file in the workspace, also before process_workspace_dir()
+ */
+static int get_launcher_file_path(char *path, size_t size, const char *file) {
+  char *workspace_dir = NULL;
+  if (get_json_string(get_config_value("zowe.workspaceDirectory"), &workspace_dir) != ZCFG_SUCCESS ||
+      strlen(workspace_dir) == 0) {
+    return -1;
+  }
+  snprintf(path, size, "%s/%s%s%s", workspace_dir, LAUNCHER_DIR, file ? "/" : "", file ? file : "");
+  return 0;
+}
+
+static int hash_config_data(ConfigManager *configmgr, uint32_t *hash) {
+  Json *config = cfgGetConfigData(configmgr, ZOWE_CONFIG_NAME);
+  if (!config) {
+    return -1;
+  }
+  zl_json_buffer_t buf = {0};
+  append_json_node(&buf, config);
+  if (!buf.failed) {
+    *hash = hash_bytes(*hash, buf.data, buf.len);
+  }
+  free(buf.data);
+  return buf.failed ? -1 : 0;
+}
+
+/**
+ * @brief Hash what the validation depends on: the merged configuration, the schema files and the
+ * launcher version
+ *
+ * @param schema_list The schema files separated by ':'
+ */
+static int hash_validation_input(ConfigManager *configmgr, const char *schema_list, uint32_t *hash) {
+  *hash = hash_string(FNV_OFFSET_BASIS, LAUNCHER_VERSION);
+  if (hash_config_data(configmgr, hash)) {
+    return -1;
+  }
+
+  char schema[PATH_MAX];
+  for (const char *start = schema_list; *start; ) {
+    const char *end = strchr(start, ':');
+    size_t len = end ? (size_t)(end - start) : strlen(start);
+    snprintf(schema, sizeof(schema), "%.*s", (int)len, start);
+    start += end ? len + 1 : len;
+
+    FILE *file = fopen(schema, "rb");
+    if (!file) {
+      DEBUG("schema '%s' not hashed - %s\n", schema, strerror(errno));
+      return -1;
+    }
+    char data[4096];
+    size_t read_len;
+    *hash = hash_string(*hash, schema);
+    while ((read_len = fread(data, 1, sizeof(data), file)) > 0) {
+      *hash = hash_bytes(*hash, data, read_len);
+    }
+    bool failed = ferror(file);
+    fclose(file);
+    if (failed) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Read the hash saved by write_hash_file() for this launcher version
+ *
+ * @return bool false if the file is missing or from another launcher version
+ */
+static bool read_hash_file(const char *file_name, const char *header, uint32_t *hash) {
+  char path[PATH_MAX];
+  if (get_launcher_file_path(path, sizeof(path), file_name)) {
+    return false;
+  }
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    return false;
+  }
+  char expected[128];
+  char line[128];
+  unsigned long saved = 0;
+  snprintf(expected, sizeof(expected), "%s %s\n", header, LAUNCHER_VERSION);
+  bool found = fgets(line, sizeof(line), file) && !strcmp(line, expected) &&
+               fgets(line, sizeof(line), file) && sscanf(line, "hash %lx", &saved) == 1;
+  fclose(file);
+  *hash = saved;
+  return found;
+}
+
+static void write_hash_file(const char *file_name, const char *header, uint32_t hash) {
+  char path[PATH_MAX];
+  char tmp_path[PATH_MAX + 16];
+  if (get_launcher_file_path(path, sizeof(path), NULL)) {
+    return;
+  }
+  if (mkdir_all(path, 0770) != 0) {
+    DEBUG("%s not saved, failed to create '%s' - %s\n", file_name, path, strerror(errno));
+    return;
+  }
+  get_launcher_file_path(path, sizeof(path), file_name);
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+
+  FILE *file = fopen(tmp_path, "w");
+  if (!file) {
+    DEBUG("%s not saved - %s\n", tmp_path, strerror(errno));
+    return;
+  }
+  fprintf(file, "%s %s\n", header, LAUNCHER_VERSION);
+  fprintf(file, "hash %08lx\n", (unsigned long)hash);
+  if (fclose(file) != 0 || rename(tmp_path, path) != 0) {
+    DEBUG("%s not saved - %s\n", path, strerror(errno));
+    unlink(tmp_path);
+  }
+}
+
+static void remove_hash_file(const char *file_name) {
+  char path[PATH_MAX];
+  if (get_launcher_file_path(path, sizeof(path), file_name) == 0) {
+    unlink(path);
+  }
+}
+
 static int process_workspace_dir(ConfigManager *configmgr) {
   DEBUG("about to get workspace dir\n");
 
@@ -1773,32 +5974,101 @@ static int process_workspace_dir(ConfigManager *configmgr) {
 }
 
 static void print_line(void *data, const char *line) {
-  printf("%s", line);
-  check_for_and_print_sys_message(line);
+  int len = strlen(line);
+  write_log(line, len, false);
+  check_for_and_print_sys_message(line, len);
+}
+
+/**
+ * @brief Run a zwe script with configmgr
+ *
+ * @return int 0 if the script succeeded
+ */
+static int run_zwe_script(const char *script, handle_line_callback_t handle_line, void *data) {
+  char bin[PATH_MAX];
+  snprintf(bin, sizeof(bin), "%s/bin/utils/configmgr", zl_context.root_dir);
+  const char *argv[] = {bin, "-script", script, NULL};
+  return run_command(argv, handle_line, data);
 }
 
-static char* get_start_prepare_cmd(char *sharedenv) {
-  const char basecmd[] = "%s ZWE_CLI_PARAMETER_CONFIG=\"%s\" %s/bin/utils/configmgr -script %s/bin/commands/internal/start/prepare/cli.js 2>&1";
-  int size = (strlen(zl_context.root_dir) * 2) + strlen(zl_context.config_path) + strlen(sharedenv) + sizeof(basecmd) + 1;
-  char *command = malloc(size);
+/**
+ * @brief Hash what the prepare step depends on: the merged configuration, the environment, the HA
+ * instance, the runtime version and the identities of the component manifests
+ */
+static int hash_prepare_input(ConfigManager *configmgr, uint32_t *hash) {
+  *hash = hash_string(FNV_OFFSET_BASIS, LAUNCHER_VERSION);
+  *hash = hash_string(*hash, zl_context.ha_instance_id);
+  if (hash_config_data(configmgr, hash)) {
+    return -1;
+  }
+  for (size_t i = 0; i < shared_uss_env_count; i++) {
+    *hash = hash_string(*hash, shared_uss_env[i]);
+  }
+
+  char path[PATH_MAX];
+  char identity[128];
+  struct stat s;
+  snprintf(path, sizeof(path), "%s/manifest.yaml", zl_context.root_dir);
+  if (stat(path, &s) != 0) {
+    return -1;
+  }
+  snprintf(identity, sizeof(identity), "%llu %llu %lld", (unsigned long long)s.st_ino,
+           (unsigned long long)s.st_size, (long long)s.st_mtime);
+  *hash = hash_string(*hash, identity);
+  snprintf(identity, sizeof(identity), "%08lx", (unsigned long)zl_context.manifest_hash);
+  *hash = hash_string(*hash, identity);
+  return 0;
+}
 
-  snprintf(command, size, basecmd,
-           sharedenv, zl_context.config_path, zl_context.root_dir, zl_context.root_dir);
-  return command;
+/**
+ * @brief Check that the workspace still holds what the prepare step wrote for the HA instance
+ */
+static bool is_workspace_prepared(void) {
+  char path[PATH_MAX];
+  struct stat s;
+  snprintf(path, sizeof(path), "%s/.env/.instance-%s.env", zl_context.workspace_dir, zl_context.ha_instance_id);
+  return stat(path, &s) == 0;
 }
 
-static int prepare_instance() {
-  char *sharedenv = get_sharedenv();
-  char *command = get_start_prepare_cmd(sharedenv);
+/**
+ * @brief Prepare the instance unless it was prepared with the same inputs and the workspace still
+ * holds the results. zowe.launcher.forcePrepare set to true always prepares.
+ */
+static int prepare_instance(ConfigManager *configmgr) {
+  bool force = false;
+  get_json_bool(get_config_value("zowe.launcher.forcePrepare"), &force);
+  uint32_t hash = 0;
+  uint32_t prepared = 0;
+  bool hashed = hash_prepare_input(configmgr, &hash) == 0;
+
+  if (!hashed) {
+    INFO(MSG_PREPARE_CACHE, 0UL, "not hashed, preparing");
+  } else if (force) {
+    INFO(MSG_PREPARE_CACHE, (unsigned long)hash, "prepare forced");
+  } else if (!read_hash_file(PREPARE_FINGERPRINT_FILE, PREPARE_FINGERPRINT_HEADER, &prepared) || prepared != hash) {
+    INFO(MSG_PREPARE_CACHE, (unsigned long)hash, "changed or not prepared, preparing");
+  } else if (!is_workspace_prepared()) {
+    INFO(MSG_PREPARE_CACHE, (unsigned long)hash, "workspace not prepared, preparing");
+  } else {
+    INFO(MSG_PREPARE_CACHE, (unsigned long)hash, "unchanged, prepare skipped");
+    return 0;
+  }
+
+  // an interrupted prepare step must not look complete
+  remove_hash_file(PREPARE_FINGERPRINT_FILE);
 
-  free(sharedenv);
+  char js_path[PATH_MAX];
+  snprintf(js_path, sizeof(js_path), "%s/bin/commands/internal/start/prepare/cli.js", zl_context.root_dir);
 
   DEBUG("about to prepare Zowe instance\n");
-  if (run_command(command, print_line, NULL)) {
+  if (run_zwe_script(js_path, print_line, NULL)) {
     ERROR(MSG_INST_PREP_ERR);
     return -1;
   }
   INFO(MSG_INST_PREPARED);
+  if (hashed) {
+    write_hash_file(PREPARE_FINGERPRINT_FILE, PREPARE_FINGERPRINT_HEADER, hash);
+  }
   return 0;
 }
 
@@ -1810,8 +6080,13 @@ static int init() {
 }
 
 static void terminate(int sig) {
+  if (zl_context.reactor_running) {
+    // the supervisor stops the components, see handle_comp_output()
+    char signal_byte = WAKEUP_BYTE_TERM;
+    write(zl_context.reactor_wakeup[1], &signal_byte, 1);
+    return;
+  }
   INFO(MSG_LAUNCHER_STOPING);
-  stop_components();
   exit(EXIT_SUCCESS);
 }
 
@@ -1867,11 +6142,102 @@ static bool validateConfiguration(ConfigManager *cmgr, FILE *out){
   return ok;
 }
 
+/**
+ * @brief Validate the configuration unless the same configuration and schemas passed the last
+ * validation. zowe.launcher.forceValidation set to true always validates.
+ */
+static bool validate_configuration_cached(ConfigManager *configmgr, const char *schema_list) {
+  bool force = false;
+  get_json_bool(get_config_value("zowe.launcher.forceValidation"), &force);
+  uint32_t hash = 0;
+  uint32_t cached = 0;
+  bool hashed = hash_validation_input(configmgr, schema_list, &hash) == 0;
+
+  if (!hashed) {
+    INFO(MSG_VALIDATION_CACHE, 0UL, "not hashed, validating");
+  } else if (force) {
+    INFO(MSG_VALIDATION_CACHE, (unsigned long)hash, "validation forced");
+  } else if (read_hash_file(VALIDATION_CACHE_FILE, VALIDATION_CACHE_HEADER, &cached) && cached == hash) {
+    INFO(MSG_VALIDATION_CACHE, (unsigned long)hash, "unchanged, validation skipped");
+    return true;
+  } else {
+    INFO(MSG_VALIDATION_CACHE, (unsigned long)hash, "changed or not cached, validating");
+  }
+
+  if (!validateConfiguration(configmgr, stdout)) {
+    return false;
+  }
+  if (hashed) {
+    write_hash_file(VALIDATION_CACHE_FILE, VALIDATION_CACHE_HEADER, hash);
+  }
+  return true;
+}
+
+/*
+ * Component initialization only reads the configuration index and the component list, so it runs
+ * on a thread of its own while the prepare script runs. The startup steps before them use the
+ * ConfigManager, which isn't thread-safe, and run one after another.
+ */
+
+typedef struct zl_init_components_t {
+  char *component_list;
+  int rc;
+  uint64_t duration; // us
+} zl_init_components_t;
+
+static void *handle_init_components(void *arg) {
+  zl_init_components_t *init = arg;
+  uint64_t begin = get_time_us();
+  init->rc = init_components(init->component_list);
+  init->duration = get_time_us() - begin;
+  return NULL;
+}
+
+/**
+ * @brief Prepare the instance and initialize the components at the same time. The components are
+ * initialized before prepare if a thread can't be created.
+ *
+ * @return int -1 if either has failed, both have finished
+ */
+static int prepare_and_init_components(ConfigManager *configmgr, char *component_list) {
+  uint64_t begin = get_time_us();
+  zl_init_components_t init = {component_list};
+  pthread_t thid;
+  bool threaded = pthread_create(&thid, NULL, handle_init_components, &init) == 0;
+  if (!threaded) {
+    DEBUG("pthread_create() for component init - %s\n", strerror(errno));
+    handle_init_components(&init);
+  }
+
+  uint64_t prepare_begin = get_time_us();
+  int rc = prepare_instance(configmgr);
+  uint64_t prepare_duration = get_time_us() - prepare_begin;
+  if (threaded) {
+    pthread_join(thid, NULL);
+  }
+  if (rc || init.rc) {
+    return -1;
+  }
+
+  uint64_t elapsed = get_time_us() - begin;
+  uint64_t serial = prepare_duration + init.duration;
+  DEBUG("prepare done in %lu ms, component init done in %lu ms\n", (unsigned long)(prepare_duration / 1000),
+        (unsigned long)(init.duration / 1000));
+  INFO(MSG_STARTUP_PHASES, (unsigned long)(elapsed / 1000), (unsigned long)(serial / 1000),
+       (unsigned long)(serial > elapsed ? (serial - elapsed) / 1000 : 0));
+  return 0;
+}
+
 int main(int argc, char **argv) {
   if (init()) {
     exit(EXIT_FAILURE);
   }
 
+  // the launcher log is written directly if the log writer can't be started
+  if (!start_log_writer()) {
+    atexit(stop_log_writer);
+  }
+
   setenv("_BPXK_AUTOCVT", "ON", 1);
   INFO(MSG_LAUNCHER_START);
   INFO(MSG_LINE_LENGTH);
@@ -1909,6 +6275,15 @@ int main(int argc, char **argv) {
     printf_wto(MSG_CFG_LOAD_FAIL); // Manual sys log print (messages not set here yet)
     exit(EXIT_FAILURE);
   }
+
+  uint64_t index_begin = get_time_us();
+  if (build_config_index(configmgr)) {
+    ERROR(MSG_CFG_INDEX_FAIL);
+    printf_wto(MSG_CFG_INDEX_FAIL); // Manual sys log print (messages not set here yet)
+    exit(EXIT_FAILURE);
+  }
+  DEBUG("configuration indexed in %lu us, paths = %d\n", (unsigned long)(get_time_us() - index_begin),
+        (int)zl_context.config_index.count);
   
   if (setup_signal_handlers()) {
     ERROR(MSG_SIGNAL_ERR);
@@ -1921,6 +6296,7 @@ int main(int argc, char **argv) {
   }
   
   set_sys_messages(configmgr);
+  set_log_writer_options();
 
   //got root dir, can now load up the schemas from it
   char schemaList[PATH_MAX*2 + 4] = {0};
@@ -1931,7 +6307,7 @@ int main(int argc, char **argv) {
     exit(EXIT_FAILURE);
   }
 
-  if (!validateConfiguration(configmgr, stdout)){
+  if (!validate_configuration_cached(configmgr, schemaList)){
     exit(EXIT_FAILURE);
   }
 
@@ -1941,19 +6317,26 @@ int main(int argc, char **argv) {
   if (process_workspace_dir(configmgr)) {
     exit(EXIT_FAILURE);
   }
+  write_config_snapshot(configmgr);
   
   char comp_buf[COMP_LIST_SIZE];
-  char *component_list = NULL;
 
-  if (prepare_instance()) {
+  // the manifests are part of the prepare inputs
+  if (get_component_list(comp_buf, sizeof(comp_buf), configmgr)) {
     exit(EXIT_FAILURE);
   }
-  if (get_component_list(comp_buf, sizeof(comp_buf), configmgr)) {
+  if (prepare_and_init_components(configmgr, comp_buf)) {
     exit(EXIT_FAILURE);
   }
-  component_list = comp_buf;
 
-  if (init_components(component_list, configmgr)) {
+  start_fork_server();
+
+  start_file_writer();
+  atexit(stop_file_writer);
+
+  if (start_reactor_thread()) {
+    ERROR(MSG_REACTOR_START_ERR);
+    free_shared_uss_env();
     exit(EXIT_FAILURE);
   }
 
@@ -1961,23 +6344,26 @@ int main(int argc, char **argv) {
 
   if (start_console_tread()) {
     ERROR(MSG_CONS_START_ERR);
-    free(shared_uss_env);
+    free_shared_uss_env();
     exit(EXIT_FAILURE);
   }
 
   monitor_events();
 
-  if (stop_console_thread()) {
+  // the console listener is still waiting for a command if the launcher
+  // has been stopped by a signal
+  if (zl_context.console_stopped && stop_console_thread()) {
     ERROR(MSG_CONS_STOP_ERR);
-    free(shared_uss_env);
+    free_shared_uss_env();
     exit(EXIT_FAILURE);
   }
 
-  stop_components();
+  stop_reactor_thread();
+  stop_fork_server();
 
   INFO(MSG_LAUNCHER_STOPPED);
 
-  free(shared_uss_env);
+  free_shared_uss_env();
   exit(EXIT_SUCCESS);
 }
 
@@ -14,6 +14,16 @@
 
 #define MSG_PREFIX "ZWEL"
 
+/*
+  Every launcher message starts with its ID: MSG_PREFIX, a 4-digit message
+  number and a severity letter. The launcher uses the number as the index of
+  the message, e.g. to decide if a message is routed to syslog, so numbers
+  must be unique and fit into MSG_NUMBER_LIMIT.
+*/
+#define MSG_PREFIX_LEN 4
+#define MSG_NUMBER_DIGITS 4
+#define MSG_NUMBER_LIMIT 10000
+
 #define MSG_COMP_STARTED        MSG_PREFIX "0001I" " component %s started\n"
 #define MSG_COMP_STOPPED        MSG_PREFIX "0002I" " component %s stopped\n"
 #define MSG_COMP_INITED         MSG_PREFIX "0003I" " new component initialized %s, restart_cnt=%d, min_uptime=%d seconds, share_as=%s\n"
@@ -88,6 +98,41 @@
 #define MSG_CFG_LOAD_FAIL       MSG_PREFIX "0072E" " Launcher Could not load configurations\n"
 #define MSG_CFG_SCHEMA_FAIL     MSG_PREFIX "0073E" " Launcher Could not load schemas, status=%d\n"
 #define MSG_NO_LOG_CONTEXT      MSG_PREFIX "0074E" " Log context was not created\n"
+#define MSG_REACTOR_START_ERR   MSG_PREFIX "0075E" " failed to start component output reactor\n"
+#define MSG_REACTOR_ERR         MSG_PREFIX "0076E" " component output reactor failed - %s\n"
+#define MSG_EVENT_STATS         MSG_PREFIX "0077I" " events enqueued = %lu, processed = %lu, dropped = %lu\n"
+#define MSG_EVENT_DROPPED       MSG_PREFIX "0078E" " event queue full, event with type %d dropped\n"
+#define MSG_LOG_STATS           MSG_PREFIX "0079I" " %s log writer queued slots = %lu, records = %lu, bytes written = %lu, flushes = %lu, avg flush time = %lu us, max flush time = %lu us, full ring waits = %lu\n"
+#define MSG_COMP_OUTPUT_STATS   MSG_PREFIX "0080I" "     output of %s: lag = %lu bytes, spilled = %lu bytes, dropped = %lu lines\n"
+#define MSG_COMP_OUTPUT_SPILLED MSG_PREFIX "0081W" " log writer is behind, output of component %s is spilled to '%s'\n"
+#define MSG_COMP_OUTPUT_DROPPED MSG_PREFIX "0082W" " log writer is behind, output of component %s is dropped\n"
+#define MSG_COMP_SPILL_ERR      MSG_PREFIX "0083E" " failed to spill output of component %s to '%s' - %s\n"
+#define MSG_LOG_FILE_ERR        MSG_PREFIX "0084E" " failed to write log file '%s' - %s\n"
+#define MSG_COMP_LOG_FILE       MSG_PREFIX "0085I" " output of component %s is written to '%s', sysprint = %s\n"
+#define MSG_COMP_DEPENDS_ON     MSG_PREFIX "0086I" " component %s depends on %s\n"
+#define MSG_DEP_UNKNOWN         MSG_PREFIX "0087W" " component %s depends on %s which is not launched, dependency ignored\n"
+#define MSG_DEP_CYCLE           MSG_PREFIX "0088W" " dependencies of component %s are part of a cycle and are ignored\n"
+#define MSG_COMP_READY          MSG_PREFIX "0089I" " component %s is ready after %lu ms\n"
+#define MSG_COMP_NOT_READY      MSG_PREFIX "0090W" " component %s is not ready within %d seconds\n"
+#define MSG_DEP_NOT_READY       MSG_PREFIX "0091W" " starting component %s although its prerequisite %s is not ready\n"
+#define MSG_STARTUP_PATH        MSG_PREFIX "0092I" " startup critical path took %lu ms: %s\n"
+#define MSG_MANIFEST_CACHE      MSG_PREFIX "0093I" " manifest cache hits = %d, misses = %d\n"
+#define MSG_CFG_INDEX_FAIL      MSG_PREFIX "0094E" " Launcher could not index the configuration\n"
+#define MSG_CMD_ENDED           MSG_PREFIX "0095I" " command '%s' ended with code %d after %lu ms\n"
+#define MSG_FORK_SERVER_STARTED MSG_PREFIX "0098I" " fork server started with PID %d\n"
+#define MSG_FORK_SERVER_ERR     MSG_PREFIX "0099W" " fork server not available, components are spawned - %s\n"
+#define MSG_FORK_SERVER_ENDED   MSG_PREFIX "0100W" " fork server ended with status %d, components are spawned\n"
+#define MSG_CFG_SNAPSHOT        MSG_PREFIX "0101I" " configuration snapshot '%s' written, hash %08lx\n"
+#define MSG_CFG_SNAPSHOT_ERR    MSG_PREFIX "0102W" " configuration snapshot not written - %s\n"
+#define MSG_VALIDATION_CACHE    MSG_PREFIX "0103I" " configuration and schemas hash %08lx, %s\n"
+#define MSG_PREPARE_CACHE       MSG_PREFIX "0104I" " prepare inputs fingerprint %08lx, %s\n"
+#define MSG_STARTUP_PHASES      MSG_PREFIX "0105I" " prepare and component init took %lu ms, %lu ms one after another, %lu ms saved\n"
+#define MSG_STOP_PHASE          MSG_PREFIX "0106I" " stopping components %s\n"
+#define MSG_SHUTDOWN_TIME       MSG_PREFIX "0107I" " shutdown took %lu ms\n"
+#define MSG_COMP_NOT_STOPPED    MSG_PREFIX "0108W" " component %s(%d) has not exited after SIGKILL, not waited for any more\n"
+#define MSG_COMP_LOG_FILE_DROPPED MSG_PREFIX "0109W" " log file writer is behind, output of component %s is not written to its log file, %lu lines dropped\n"
+#define MSG_COMP_LOG_FILE_STATS MSG_PREFIX "0110I" "     log file of %s: dropped = %lu lines\n"
+#define MSG_FORK_SERVER_COMP    MSG_PREFIX "0112W" " component %s(%d) forked by the fork server that has ended is killed\n"
 #define MSG_LINE_LENGTH         "-- If you cant see '500' at the end of the line, your log is too short to read!80--------90------ 100----------------------125----------------------150----------------------175----------------------200----------------------225----------------------250----------------------275----------------------300----------------------325----------------------350----------------------375----------------------400----------------------425----------------------450----------------------475----------------------500\n"
 
 #endif // MSG_H